@@ -5,6 +5,10 @@
  */
 #include "CTFactory.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
 #include <iostream>
 #include <thread>
 
@@ -14,6 +18,9 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
+#include "FalloffTable.h"
+#include "Orientation.h"
+#include "SeamBank.h"
 #include "WalkingGradient.h"
 
 
@@ -23,9 +30,12 @@
  * @param width the width of the gradient
  * @param height the height of the gradient
  * @param isCorner if the desired gradient should be a corner piece, otherwise edge piece
+ * @param tile id of the tile, selects its own random stream so tiles can be regenerated independently
  */
-static WGSettings getWGS(const CTSettings& props, int width, int height, bool isCorner) {
+static WGSettings getWGS(const CTSettings& props, int width, int height, bool isCorner, int tile) {
     WGSettings wgs = WGSettings();
+    wgs.seed = props.seed;
+    wgs.tile = tile;
     wgs.sampleCount = props.sampleCount;
     wgs.width = width;
     wgs.height = height;
@@ -33,10 +43,101 @@ static WGSettings getWGS(const CTSettings& props, int width, int height, bool is
     wgs.seamHeight = props.seamHeight;
     wgs.variance = props.variance;
     wgs.steepness = props.steepness;
+    wgs.backend = props.backend;
+    wgs.narrowBand = props.narrowBand;
+    wgs.threads = props.threads;
+    wgs.coarseFactor = props.coarseFactor;
+    wgs.splineSegments = props.splineSegments;
+    wgs.curve = props.curve;
+    wgs.curveSamples = props.curveSamples;
+    wgs.storage = props.storage;
+    wgs.seam = props.seam;
+    wgs.seamDetail = props.seamDetail;
+    wgs.seamMargin = props.seamMargin;
+    wgs.seamBank = props.seamBank;
+    wgs.seamPath = isCorner ? props.cornerSeamPath : props.edgeSeamPath;
+    wgs.keepDistance = false;   // Tiles are blended once, only the gradient values are needed
     return wgs;
 }
 
-CTFactory::CTFactory(const fs::path& topImagePath, const fs::path& bottomImagePath, const fs::path& outImagePath, const CTSettings& props) : props(props) {
+/**
+ * Names of the tiles indexed by tile id, followed by the top and bottom base tiles
+ */
+static const char *TILE_NAMES[CTFactory::TILE_COUNT + 2] = {
+    "NE", "NW", "SE", "SW", "N", "S", "E", "W", "NE inverse", "NW inverse", "SE inverse", "SW inverse", "top", "bottom"
+};
+
+/**
+ * Whether each tile's seam, walked from its first sample, has the bottom image on its left
+ * once the tile is oriented and blended, indexed by tile id
+ * 
+ * Edge seams walk with the top image on their left and corner seams with it on their right.
+ * Every flip, transpose or inverse blend of a tile swaps that side.
+ */
+static const bool SEAM_REVERSED[CTFactory::TILE_COUNT] = {
+    false, true, true, false,   // NE, NW, SE, SW
+    true, false, true, false,   // N, S, E, W
+    true, false, false, true    // NE, NW, SE, SW inverse
+};
+
+/**
+ * Creates the walking gradient settings of a tile, with sharedBorder its seam begins and ends
+ * with the atlas' boundary seam so it continues exactly into any neighbouring tile
+ * 
+ * @param props the CTSettings object provided by a CTFactory object
+ * @param width the width of the tile
+ * @param height the height of the tile
+ * @param boundarySeam offsets of the atlas' boundary seam, empty without sharedBorder
+ * @param isCorner if the desired gradient should be a corner piece, otherwise edge piece
+ * @param tile id of the tile
+ */
+static WGSettings getBorderedWGS(const CTSettings& props, int width, int height, const std::vector<float>& boundarySeam, bool isCorner, int tile) {
+    WGSettings wgs = getWGS(props, width, height, isCorner, tile);
+    if (boundarySeam.empty())
+        return wgs;
+
+    // Walked with the top image on its left, every seam leaves its tile with the end of the
+    // boundary seam and enters the next one with its start, so every border crossing is the
+    // same run of offsets and tiles match in any arrangement
+    wgs.isCorner = true;
+    int reach = std::min(props.sharedBorder, (WalkingGradient::getSeamSampleCount(wgs) - 1) / 4);
+    wgs.isCorner = isCorner;
+    std::vector<float> crossing(boundarySeam.end() - reach - 1, boundarySeam.end());
+    crossing.insert(crossing.end(), boundarySeam.begin() + 1, boundarySeam.begin() + reach + 1);
+    if (SEAM_REVERSED[tile])
+        std::reverse(crossing.begin(), crossing.end());
+    wgs.seamStart = crossing;
+    wgs.seamEnd = crossing;
+
+    // Offsets grow towards the bottom image, which inverse tiles blend as the top image
+    if (tile >= 8) {
+        for (float& offset : wgs.seamStart)
+            offset = -offset;
+        for (float& offset : wgs.seamEnd)
+            offset = -offset;
+    }
+    return wgs;
+}
+
+/**
+ * Gets the orientation a tile's gradient is read in, edge tiles E and W are generated
+ * with the tile's width and height swapped and read transposed
+ * 
+ * @param tile id of the tile
+ * @return the tile's view
+ */
+static Orientation getTileView(int tile) {
+    Orientation view;
+    if (tile == 6 || tile == 7)
+        view.transpose();
+    if (tile == 1 || tile == 3 || tile == 7 || tile == 9 || tile == 11)
+        view.flipX();
+    if (tile == 0 || tile == 1 || tile == 4 || tile == 8 || tile == 9)
+        view.flipY();
+    return view;
+}
+
+CTFactory::CTFactory(const fs::path& topImagePath, const fs::path& bottomImagePath, const fs::path& outImagePath, const CTSettings& props) : props(props), tileStats(TILE_COUNT), tileBlendMs(TILE_COUNT) {
     
     topImage.pixels = stbi_load(topImagePath.string().c_str(), &topImage.x, &topImage.y, &topImage.c, 0);
     bottomImage.pixels = stbi_load(bottomImagePath.string().c_str(), &bottomImage.x, &bottomImage.y, &bottomImage.c, 0);
@@ -65,6 +166,13 @@ CTFactory::CTFactory(const fs::path& topImagePath, const fs::path& bottomImagePa
     outImage.c = (topImage.c < bottomImage.c) ? topImage.c : bottomImage.c;
     outImage.pixels = new unsigned char[outImage.x * outImage.y * outImage.c]();
 
+    // One boundary seam per atlas, every tile border crossing continues it
+    if (props.sharedBorder > 0) {
+        WGSettings wgs = getWGS(props, topImage.x, topImage.y, false, TILE_COUNT);
+        boundarySeam.resize(WalkingGradient::getSeamSampleCount(wgs));
+        WalkingGradient::generateSeamOffsets(wgs, boundarySeam.data());
+    }
+
     std::thread ne_thread(&CTFactory::generateNETile, this);
     std::thread nw_thread(&CTFactory::generateNWTile, this);
     std::thread se_thread(&CTFactory::generateSETile, this);
@@ -94,6 +202,7 @@ CTFactory::CTFactory(const fs::path& topImagePath, const fs::path& bottomImagePa
     sw_inv_thread.join();
 
     stbi_write_png(outImagePath.string().c_str(), outImage.x, outImage.y, outImage.c, outImage.pixels, 0);
+    printSummary();
 }
 
 CTFactory::~CTFactory() {
@@ -109,25 +218,203 @@ CTFactory::~CTFactory() {
     }
 }
 
-void CTFactory::applyTileBlend(const WalkingGradient& g, int xOffset, int yOffset, bool inverse) {
+WGSettings CTFactory::getTileWGS(bool isCorner, int tile) const {
+    return getBorderedWGS(props, topImage.x, topImage.y, boundarySeam, isCorner, tile);
+}
+
+void CTFactory::benchmark(const CTSettings& props, int size) {
+    WalkingGradient::benchmark(getWGS(props, size, size, false, 0));
+}
+
+void CTFactory::checkBorders(const CTSettings& props, int size, int count) {
+    // Mirrored views read the seam one pixel over, so across a border a pixel may meet its
+    // diagonal neighbour, neither a border nor a tile should change by more than the curve
+    // does over one pixel diagonal (and one storage step)
+    FalloffTable table(props.curve, props.steepness, props.curveSamples);
+    float allowed = 0.0f;
+    for (float d = -props.steepness - 2.0f; d <= props.steepness + 2.0f; d += 0.01f)
+        allowed = std::max(allowed, std::abs(table(d + std::sqrt(2.0f)) - table(d)));
+    allowed += 1.0f / 255.0f;
+
+    // Bottom image weight of every tile as it is blended, the base tiles are constant
+    const int tileCount = TILE_COUNT + 2;
+    std::vector<std::vector<float>> weights(tileCount, std::vector<float>(size * size));
+    std::fill(weights[TILE_COUNT + 1].begin(), weights[TILE_COUNT + 1].end(), 1.0f);
+
+    int mismatched = 0;
+    float largestJump = 0.0f, largestStep = 0.0f;
+    std::cout << std::fixed << std::setprecision(3);
+    for (int i = 0; i < count; ++i) {
+        CTSettings seedProps = props;
+        seedProps.seed = props.seed + i;
+        std::vector<float> boundarySeam;
+        if (props.sharedBorder > 0) {
+            WGSettings wgs = getWGS(seedProps, size, size, false, TILE_COUNT);
+            boundarySeam.resize(WalkingGradient::getSeamSampleCount(wgs));
+            WalkingGradient::generateSeamOffsets(wgs, boundarySeam.data());
+        }
+
+        float step = 0.0f;
+        int stepTile = 0;
+        for (int tile = 0; tile < TILE_COUNT; ++tile) {
+            bool isCorner = tile < 4 || tile >= 8;
+            WGSettings wgs = getBorderedWGS(seedProps, size, size, boundarySeam, isCorner, tile);
+            Orientation view = getTileView(tile);
+            if (view.swapAxes)
+                std::swap(wgs.width, wgs.height);
+            WalkingGradient wg(wgs);
+            std::vector<float>& w = weights[tile];
+            visitStorage(wg.getStorage(), [&](auto type) {
+                using T = decltype(type);
+                const T *values = wg.getValues<T>();
+                int columnStep = view.columnStep(wg.getWidth());
+                for (int y = 0; y < size; ++y) {
+                    int gInd = view.rowStart(y, wg.getWidth(), wg.getHeight());
+                    for (int x = 0; x < size; ++x, gInd += columnStep) {
+                        float value = StorageTraits<T>::decode(values[gInd]);
+                        w[y * size + x] = tile >= 8 ? 1.0f - value : value;
+                    }
+                }
+            });
+            for (int y = 1; y < size; ++y) {
+                for (int x = 1; x < size; ++x) {
+                    float tileStep = std::max(std::abs(w[y * size + x] - w[(y - 1) * size + x - 1]), std::abs(w[y * size + x - 1] - w[(y - 1) * size + x]));
+                    if (tileStep > step) {
+                        step = tileStep;
+                        stepTile = tile;
+                    }
+                }
+            }
+        }
+
+        // Tiles may sit side by side when the corners of the touching border agree
+        float jump = 0.0f;
+        int jumpFirst = 0, jumpSecond = 0, jumpAt = 0;
+        bool jumpVertical = false;
+        for (int vertical = 0; vertical < 2; ++vertical) {
+            // Index of the pixel at position along the first tile's far border and the second tile's near border
+            auto farIndex = [&](int at) { return vertical ? (size - 1) * size + at : at * size + size - 1; };
+            auto nearIndex = [&](int at) { return vertical ? at : at * size; };
+            for (int first = 0; first < tileCount; ++first) {
+                const std::vector<float>& a = weights[first];
+                for (int second = 0; second < tileCount; ++second) {
+                    const std::vector<float>& b = weights[second];
+                    if ((a[farIndex(0)] < 0.5f) != (b[nearIndex(0)] < 0.5f) || (a[farIndex(size - 1)] < 0.5f) != (b[nearIndex(size - 1)] < 0.5f))
+                        continue;
+                    for (int at = 0; at < size; ++at) {
+                        float difference = std::abs(a[farIndex(at)] - b[nearIndex(at)]);
+                        if (difference > jump) {
+                            jump = difference;
+                            jumpFirst = first;
+                            jumpSecond = second;
+                            jumpAt = at;
+                            jumpVertical = vertical;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (jump > allowed || step > allowed) {
+            ++mismatched;
+            std::cout << "seed " << seedProps.seed << ": " << TILE_NAMES[jumpFirst] << (jumpVertical ? " above " : " left of ") << TILE_NAMES[jumpSecond]
+                      << " differs by " << jump << " at " << (jumpVertical ? "column " : "row ") << jumpAt
+                      << ", " << TILE_NAMES[stepTile] << " steps by " << step << " inside" << std::endl;
+        }
+        largestJump = std::max(largestJump, jump);
+        largestStep = std::max(largestStep, step);
+    }
+    std::cout << "Borders and tiles change by at most " << allowed << " per pixel for " << count - mismatched << " of " << count
+              << " seeds, largest border difference " << largestJump << ", largest step inside a tile " << largestStep << std::endl;
+}
+
+bool CTFactory::writeSeamBank(const CTSettings& props, const fs::path& path, int count) {
+    // Banked seams are offsets from seamHeight, so the tile size does not matter
+    return SeamBank::write(path, getWGS(props, 0, 0, false, 0), count);
+}
+
+/**
+ * Blends one pixel of the top and bottom image by a gradient value
+ * 
+ * Floating point values are weights between 0.0 and 1.0, fixed point values are
+ * blended in integer arithmetic without converting them.
+ * 
+ * @param t top image pixel
+ * @param b bottom image pixel
+ * @param o out: output image pixel
+ * @param channels amount of channels to blend
+ * @param r the gradient value
+ */
+static void blendPixel(const unsigned char *t, const unsigned char *b, unsigned char *o, int channels, float r) {
+    float ir = 1.f - r;
+    for (int c = 0; c < channels; ++c) {
+        o[c] = (unsigned char)(ir * (float)t[c] + r * (float)b[c]);
+    }
+}
+
+static void blendPixel(const unsigned char *t, const unsigned char *b, unsigned char *o, int channels, Half r) {
+    blendPixel(t, b, o, channels, StorageTraits<Half>::decode(r));
+}
+
+static void blendPixel(const unsigned char *t, const unsigned char *b, unsigned char *o, int channels, std::uint16_t r) {
+    std::uint32_t ir = 65535 - r;
+    for (int c = 0; c < channels; ++c) {
+        o[c] = (unsigned char)((ir * t[c] + std::uint32_t(r) * b[c]) / 65535);
+    }
+}
+
+static void blendPixel(const unsigned char *t, const unsigned char *b, unsigned char *o, int channels, std::uint8_t r) {
+    unsigned ir = 255 - r;
+    for (int c = 0; c < channels; ++c) {
+        o[c] = (unsigned char)((ir * t[c] + unsigned(r) * b[c]) / 255);
+    }
+}
+
+void CTFactory::applyTileBlend(const WalkingGradient& g, const Orientation& view, int tile, int xOffset, int yOffset, bool inverse) {
+    auto start = std::chrono::steady_clock::now();
     const ImageData& tData = !inverse ? topImage : bottomImage;
     const ImageData& bData = !inverse ? bottomImage : topImage;
     unsigned char* o_im = outImage.pixels;
 
-    for (int y = 0; y < tData.y; ++y) {
-        int yOut = yOffset + y;
-        for (int x = 0; x < tData.x; ++x) {
-            int xOut = xOffset + x;
-            int outInd = (yOut * outImage.x + xOut) * outImage.c;
-            int t_inInd = (y * tData.x + x) * tData.c;
-            int b_inInd = (y * bData.x + x) * bData.c;
-            float r = g.getValue(x, y);
-            float ir = 1.f - r;
-            for (int c = 0; c < outImage.c; ++c) {
-                o_im[outInd + c] = (unsigned char)(ir * (float)tData.pixels[t_inInd + c] + r * (float)bData.pixels[b_inInd + c]);
+    // Dispatch on the storage type once, so the pixel loop reads the values directly
+    visitStorage(g.getStorage(), [&](auto type) {
+        const auto *values = g.getValues<decltype(type)>();
+        // Transposed views read a gradient generated with the tile's width and height swapped
+        int step = view.columnStep(g.getWidth());
+        for (int y = 0; y < tData.y; ++y) {
+            int yOut = yOffset + y;
+            int gInd = view.rowStart(y, g.getWidth(), g.getHeight());
+            for (int x = 0; x < tData.x; ++x, gInd += step) {
+                int xOut = xOffset + x;
+                int outInd = (yOut * outImage.x + xOut) * outImage.c;
+                int t_inInd = (y * tData.x + x) * tData.c;
+                int b_inInd = (y * bData.x + x) * bData.c;
+                blendPixel(tData.pixels + t_inInd, bData.pixels + b_inInd, o_im + outInd, outImage.c, values[gInd]);
             }
         }
+    });
+
+    tileStats[tile] = g.getStats();
+    tileBlendMs[tile] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void CTFactory::printSummary() const {
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::setw(10) << "tile" << std::setw(12) << "seam ms"
+              << std::setw(14) << "distance ms" << std::setw(13) << "falloff ms" << std::setw(11) << "blend ms" << std::endl;
+    WGStats total;
+    double totalBlendMs = 0.0;
+    for(int tile = 0; tile < TILE_COUNT; ++tile) {
+        const WGStats& stats = tileStats[tile];
+        std::cout << std::setw(10) << TILE_NAMES[tile] << std::setw(12) << stats.seamMs
+                  << std::setw(14) << stats.distanceMs << std::setw(13) << stats.falloffMs << std::setw(11) << tileBlendMs[tile] << std::endl;
+        total.seamMs += stats.seamMs;
+        total.distanceMs += stats.distanceMs;
+        total.falloffMs += stats.falloffMs;
+        totalBlendMs += tileBlendMs[tile];
     }
+    std::cout << std::setw(10) << "total" << std::setw(12) << total.seamMs
+              << std::setw(14) << total.distanceMs << std::setw(13) << total.falloffMs << std::setw(11) << totalBlendMs << std::endl;
 }
 
 void CTFactory::applyBaseTile(bool useTopImage, int xOffset, int yOffset) {
@@ -149,85 +436,75 @@ void CTFactory::applyBaseTile(bool useTopImage, int xOffset, int yOffset) {
 }
 
 void CTFactory::generateNETile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, true);
+    WGSettings wgs = getTileWGS(true, 0);
     WalkingGradient wg(wgs);
-    wg.flipY();
-    applyTileBlend(wg, 2 * topImage.x, 0);
+    applyTileBlend(wg, getTileView(0), 0, 2 * topImage.x, 0);
 }
 
 void CTFactory::generateNWTile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, true);
+    WGSettings wgs = getTileWGS(true, 1);
     WalkingGradient wg(wgs);
-    wg.flipX();
-    wg.flipY();
-    applyTileBlend(wg, 0, 0);
+    applyTileBlend(wg, getTileView(1), 1, 0, 0);
 }
 
 void CTFactory::generateSETile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, true);
+    WGSettings wgs = getTileWGS(true, 2);
     WalkingGradient wg(wgs);
-    applyTileBlend(wg, 2 * topImage.x, 2 * topImage.y);
+    applyTileBlend(wg, getTileView(2), 2, 2 * topImage.x, 2 * topImage.y);
 }
 
 void CTFactory::generateSWTile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, true);
+    WGSettings wgs = getTileWGS(true, 3);
     WalkingGradient wg(wgs);
-    wg.flipX();
-    applyTileBlend(wg, 0, 2 * topImage.y);
+    applyTileBlend(wg, getTileView(3), 3, 0, 2 * topImage.y);
 }
 
 void CTFactory::generateNTile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, false);
+    WGSettings wgs = getTileWGS(false, 4);
     WalkingGradient wg(wgs);
-    wg.flipY();
-    applyTileBlend(wg, topImage.x, 0);
+    applyTileBlend(wg, getTileView(4), 4, topImage.x, 0);
 }
 
 void CTFactory::generateSTile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, false);
+    WGSettings wgs = getTileWGS(false, 5);
     WalkingGradient wg(wgs);
-    applyTileBlend(wg, topImage.x, 2 * topImage.y);
+    applyTileBlend(wg, getTileView(5), 5, topImage.x, 2 * topImage.y);
 }
 
 void CTFactory::generateETile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, false);
+    WGSettings wgs = getTileWGS(false, 6);
+    std::swap(wgs.width, wgs.height);
     WalkingGradient wg(wgs);
-    wg.transpose();
-    applyTileBlend(wg, 2 * topImage.x, topImage.y);
+    applyTileBlend(wg, getTileView(6), 6, 2 * topImage.x, topImage.y);
 }
 
 void CTFactory::generateWTile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, false);
+    WGSettings wgs = getTileWGS(false, 7);
+    std::swap(wgs.width, wgs.height);
     WalkingGradient wg(wgs);
-    wg.transpose();
-    wg.flipX();
-    applyTileBlend(wg, 0, topImage.y);
+    applyTileBlend(wg, getTileView(7), 7, 0, topImage.y);
 }
 
 void CTFactory::generateNEInverseTile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, true);
+    WGSettings wgs = getTileWGS(true, 8);
     WalkingGradient wg(wgs);
-    wg.flipY();
-    applyTileBlend(wg, 4 * topImage.x, 0, true);
+    applyTileBlend(wg, getTileView(8), 8, 4 * topImage.x, 0, true);
 }
 
 void CTFactory::generateNWInverseTile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, true);
+    WGSettings wgs = getTileWGS(true, 9);
     WalkingGradient wg(wgs);
-    wg.flipX();
-    wg.flipY();
-    applyTileBlend(wg, 3 * topImage.x, 0, true);
+    applyTileBlend(wg, getTileView(9), 9, 3 * topImage.x, 0, true);
 }
 
 void CTFactory::generateSEInverseTile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, true);
+    WGSettings wgs = getTileWGS(true, 10);
     WalkingGradient wg(wgs);
-    applyTileBlend(wg, 4 * topImage.x, topImage.y, true);
+    applyTileBlend(wg, getTileView(10), 10, 4 * topImage.x, topImage.y, true);
 }
 
 void CTFactory::generateSWInverseTile() {
-    WGSettings wgs = getWGS(props, topImage.x, topImage.y, true);
+    WGSettings wgs = getTileWGS(true, 11);
     WalkingGradient wg(wgs);
-    wg.flipX();
-    applyTileBlend(wg, 3 * topImage.x, topImage.y, true);
+    applyTileBlend(wg, getTileView(11), 11, 3 * topImage.x, topImage.y, true);
 }
\ No newline at end of file
@@ -5,9 +5,19 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <vector>
 
+class SeamBank;
+struct Orientation;
 class WalkingGradient;
+struct WGSettings;
+struct WGStats;
+enum class WGBackend;
+enum class FalloffCurve;
+enum class WGStorage;
+enum class WGSeam;
 
 namespace fs = std::filesystem;
 
@@ -18,10 +28,26 @@ namespace fs = std::filesystem;
  * Settings used to generate a connected texture
  */
 struct CTSettings {
+    std::uint64_t seed;
     int sampleCount;
     float variance;
     float steepness;
     float seamHeight;
+    WGBackend backend;
+    bool narrowBand;
+    int threads;
+    int coarseFactor;
+    int splineSegments;
+    FalloffCurve curve;
+    std::vector<float> curveSamples;
+    WGStorage storage;
+    WGSeam seam;
+    int seamDetail;
+    float seamMargin;
+    const SeamBank *seamBank;   // Pre-generated seams to pick from, nullptr generates every seam
+    int sharedBorder;           // Seam samples on each side of a tile border shared by all tiles, 0 disables
+    std::vector<float> edgeSeamPath;    // Hand-authored edge seam as interleaved x, y pixels, empty for random seams
+    std::vector<float> cornerSeamPath;  // Hand-authored corner seam as interleaved x, y pixels, empty for random seams
 };
 
 struct ImageData {
@@ -39,6 +65,7 @@ class CTFactory {
     public:
         const unsigned char OUTPUT_TILE_WIDTH = 5;
         const unsigned char OUTPUT_TILE_HEIGHT = 3;
+        static const int TILE_COUNT = 12;
 
         /**
          * CTFactory constructor
@@ -57,20 +84,74 @@ class CTFactory {
          * Cleans up pointer members
          */
         virtual ~CTFactory();
+
+
+        /**
+         * Benchmarks every gradient backend on square tiles of the given size
+         * 
+         * @param props connected texture generation settings
+         * @param size the width and height of the benchmarked gradients
+         */
+        static void benchmark(const CTSettings& props, int size);
+
+
+        /**
+         * Generates every tile for a run of seeds and reports how far the values of tiles that may
+         * sit side by side differ across their shared border, compared to the steps inside a tile
+         * 
+         * @param props connected texture generation settings, the first seed of the run
+         * @param size the width and height of the checked tiles
+         * @param count amount of consecutive seeds checked
+         */
+        static void checkBorders(const CTSettings& props, int size, int count);
+
+
+        /**
+         * Generates edge and corner seams with the given settings and writes them as a seam bank
+         * 
+         * @param props connected texture generation settings
+         * @param path the bank file to write
+         * @param count amount of edge seams and of corner seams
+         * @return true if the bank could be written
+         */
+        static bool writeSeamBank(const CTSettings& props, const fs::path& path, int count);
     
     private:
         ImageData topImage, bottomImage, outImage;
         CTSettings props;
+        std::vector<WGStats> tileStats;
+        std::vector<double> tileBlendMs;
+        std::vector<float> boundarySeam;
+
+
+        /**
+         * Creates the walking gradient settings of a tile
+         * 
+         * With sharedBorder the tile's seam begins and ends with the atlas' boundary seam,
+         * so it continues exactly into any neighbouring tile.
+         * 
+         * @param isCorner if the desired gradient should be a corner piece, otherwise edge piece
+         * @param tile id of the tile
+         */
+        WGSettings getTileWGS(bool isCorner, int tile) const;
+
+
+        /**
+         * Prints the construction statistics and blend time of every tile
+         */
+        void printSummary() const;
 
         /**
          * Uses color blending to apply a connected texture to the output image
          * 
          * @param g a walking gradient determining how the textures should blend
+         * @param view orientation the gradient is read in, applied per pixel instead of moving the values
+         * @param tile id of the tile, its statistics are recorded for the summary
          * @param xOffset the starting x position on the output image to draw to
          * @param yOffset the starting y position on the output image to draw to
          * @param inverse if true, will swap top and bottom image
          */
-        void applyTileBlend(const WalkingGradient& g, int xOffset, int yOffset, bool inverse = false);
+        void applyTileBlend(const WalkingGradient& g, const Orientation& view, int tile, int xOffset, int yOffset, bool inverse = false);
 
 
         /**
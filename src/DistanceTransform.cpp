@@ -0,0 +1,89 @@
+/**
+ * @file DistanceTransform.cpp
+ * 
+ * DistanceTransform implementation file
+ */
+#include "DistanceTransform.h"
+
+#include <algorithm>
+
+
+/**
+ * One dimensional squared distance transform of a sampled function
+ * 
+ * @param f sampled function of length n
+ * @param d out: d[q] = min over p of (q - p)^2 + f[p]
+ * @param arg out: the p minimizing d[q]
+ * @param n length of the sampled function
+ * @param v scratch buffer of length n
+ * @param z scratch buffer of length n + 1
+ */
+static void distanceTransform1D(const float *f, float *d, int *arg, int n, int *v, float *z) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -DT_INF;
+    z[1] = DT_INF;
+    for(int q = 1; q < n; ++q) {
+        float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+        while(s <= z[k]) {
+            --k;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * (q - v[k]));
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = DT_INF;
+    }
+
+    k = 0;
+    for(int q = 0; q < n; ++q) {
+        while(z[k + 1] < q)
+            ++k;
+        float dq = (float)(q - v[k]);
+        d[q] = dq * dq + f[v[k]];
+        arg[q] = v[k];
+    }
+}
+
+void distanceTransform(int *feature, int width, int height) {
+    int n = std::max(width, height);
+    float *f = new float[n];
+    float *d = new float[n];
+    int *arg = new int[n];
+    int *v = new int[n];
+    float *z = new float[n + 1];
+    int *rows = new int[width];
+
+    // Column pass, remember which row the minimum came from, -1 for columns without seeds
+    for(int x = 0; x < width; ++x) {
+        for(int y = 0; y < height; ++y)
+            f[y] = feature[y * width + x] < 0 ? DT_INF : 0.0f;
+        distanceTransform1D(f, d, arg, height, v, z);
+        for(int y = 0; y < height; ++y)
+            feature[y * width + x] = d[y] >= DT_INF ? -1 : arg[y];
+    }
+
+    // Row pass, combine the column minimum with the winning column
+    for(int y = 0; y < height; ++y) {
+        int yOffset = y * width;
+        std::copy(feature + yOffset, feature + yOffset + width, rows);
+        for(int x = 0; x < width; ++x) {
+            float dy = (float)(y - rows[x]);
+            f[x] = rows[x] < 0 ? DT_INF : dy * dy;
+        }
+        distanceTransform1D(f, d, arg, width, v, z);
+        for(int x = 0; x < width; ++x) {
+            if(d[x] >= DT_INF)
+                feature[yOffset + x] = -1;
+            else
+                feature[yOffset + x] = rows[arg[x]] * width + arg[x];
+        }
+    }
+
+    delete[] rows;
+    delete[] z;
+    delete[] v;
+    delete[] arg;
+    delete[] d;
+    delete[] f;
+}
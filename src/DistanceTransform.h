@@ -0,0 +1,30 @@
+/**
+ * @file DistanceTransform.h
+ * 
+ * DistanceTransform header file
+ */
+#pragma once
+
+
+/**
+ * Value used to mark grid cells that are not seeds
+ * 
+ * Large but finite so that parabola intersections stay well defined
+ */
+constexpr float DT_INF = 1e20f;
+
+
+/**
+ * Computes the exact euclidean distance transform of a grid in place
+ * 
+ * Uses the separable lower envelope of parabolas algorithm by Felzenszwalb
+ * and Huttenlocher, one column pass followed by one row pass, in O(width * height).
+ * The column pass keeps only the row of each column's nearest seed, its squared
+ * distance follows from that, so the grid itself is the only width * height buffer.
+ * 
+ * @param feature in: non-negative for seed cells and -1 otherwise, out: index (y * width + x)
+ *                of the nearest seed cell, -1 if the grid has no seeds
+ * @param width the width of the grid
+ * @param height the height of the grid
+ */
+void distanceTransform(int *feature, int width, int height);
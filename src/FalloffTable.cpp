@@ -0,0 +1,65 @@
+/**
+ * @file FalloffTable.cpp
+ * 
+ * FalloffTable implementation file
+ */
+#include "FalloffTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+/**
+ * Evaluates a falloff curve
+ * 
+ * @param curve shape of the blend
+ * @param samples curve values used by FalloffCurve::Table
+ * @param t position across the blend, 0.0 fully bottom and 1.0 fully top
+ * @return gradient value between 0.0 and 1.0
+ */
+static float evaluateCurve(FalloffCurve curve, const std::vector<float>& samples, float t) {
+    switch(curve) {
+        case FalloffCurve::Smoothstep:
+            return t * t * (3.0f - 2.0f * t);
+        case FalloffCurve::Cosine:
+            return 0.5f - 0.5f * std::cos(float(M_PI) * t);
+        case FalloffCurve::Table: {
+            if(samples.size() < 2)
+                return t;
+            float position = t * (samples.size() - 1);
+            int i = std::min(int(position), int(samples.size()) - 2);
+            float fraction = position - i;
+            return samples[i] + (samples[i + 1] - samples[i]) * fraction;
+        }
+        default:
+            return t;
+    }
+}
+
+FalloffTable::FalloffTable(FalloffCurve curve, float steepness, const std::vector<float>& samples) : table(SIZE) {
+    // Entry i covers the distances quantizing down to it, so it is sampled at its center
+    scale = SIZE / (2.0f * steepness);
+    offset = SIZE * 0.5f;
+    for(int i = 0; i < SIZE; ++i) {
+        float t = (i + 0.5f) / SIZE;
+        table[i] = std::clamp(evaluateCurve(curve, samples, t), 0.0f, 1.0f);
+    }
+    // Saturated distances map exactly onto the image they are in
+    table[0] = std::clamp(evaluateCurve(curve, samples, 0.0f), 0.0f, 1.0f);
+    table[SIZE - 1] = std::clamp(evaluateCurve(curve, samples, 1.0f), 0.0f, 1.0f);
+}
+
+bool FalloffTable::loadCurve(const fs::path& path, std::vector<float>& samples) {
+    std::ifstream inf(path);
+    samples.clear();
+    float value;
+    while(inf >> value) {
+        samples.push_back(std::clamp(value, 0.0f, 1.0f));
+    }
+    return samples.size() >= 2;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file FalloffTable.h
+ * 
+ * FalloffTable header file
+ */
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+
+/**
+ * Definition of the FalloffCurve enum
+ * 
+ * Shape of the blend between the bottom and top image across the seam
+ */
+enum class FalloffCurve {
+    Linear,     // Straight ramp, the original gradient
+    Smoothstep, // 3t^2 - 2t^3, flat where the blend starts and ends
+    Cosine,     // Half cosine wave, flat where the blend starts and ends
+    Table       // User supplied samples, linearly interpolated
+};
+
+
+/**
+ * Definition of the FalloffTable class
+ * 
+ * Lookup table from quantized signed seam distance to gradient value. The curve is baked
+ * into the table, so every curve costs one multiply-add, one clamp and one load per pixel.
+ */
+class FalloffTable {
+    public:
+
+        /**
+         * Bakes a curve over the signed distances -steepness to steepness
+         * 
+         * @param curve shape of the blend
+         * @param steepness the reach of the gradient's blending in pixels
+         * @param samples curve values at evenly spaced points from fully bottom to fully top, used by FalloffCurve::Table
+         */
+        FalloffTable(FalloffCurve curve, float steepness, const std::vector<float>& samples = {});
+
+
+        /**
+         * Maps a signed seam distance to a gradient value
+         * 
+         * @param signedDistance distance to the seam, positive above (edge) or outside (corner) of it
+         * @return gradient value between 0.0 and 1.0
+         */
+        float operator()(float signedDistance) const {
+            float index = std::clamp(signedDistance * scale + offset, 0.0f, float(SIZE - 1));
+            return table[int(index)];
+        }
+
+
+        /**
+         * Reads curve samples from a text file of whitespace separated values
+         * 
+         * @param path the curve file
+         * @param samples out: the curve values, clamped between 0.0 and 1.0
+         * @return true if the file held at least two values
+         */
+        static bool loadCurve(const fs::path& path, std::vector<float>& samples);
+
+    private:
+        static constexpr int SIZE = 4096;
+
+        std::vector<float> table;
+        float scale, offset;
+};
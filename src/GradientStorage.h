@@ -0,0 +1,119 @@
+/**
+ * @file GradientStorage.h
+ * 
+ * GradientStorage header file
+ */
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+
+/**
+ * Definition of the WGStorage enum
+ * 
+ * Type gradient values are stored as
+ */
+enum class WGStorage {
+    Float,  // 4 bytes per pixel, exact
+    Half,   // 2 bytes per pixel, IEEE half precision
+    UInt16, // 2 bytes per pixel, fixed point steps of 1/65535
+    UInt8   // 1 byte per pixel, fixed point steps of 1/255, matches 8-bit output
+};
+
+
+/**
+ * Definition of the Half struct
+ * 
+ * Raw bits of an IEEE 754 half precision float
+ */
+struct Half {
+    std::uint16_t bits;
+};
+
+
+/**
+ * Definition of the StorageTraits struct
+ * 
+ * Conversions between gradient values in [0, 1] and a storage type
+ */
+template<typename T>
+struct StorageTraits;
+
+template<>
+struct StorageTraits<float> {
+    static float encode(float value) { return value; }
+    static float decode(float value) { return value; }
+    static float invert(float value) { return 1.0f - value; }
+};
+
+template<>
+struct StorageTraits<Half> {
+    static Half encode(float value) {
+        std::uint32_t x;
+        std::memcpy(&x, &value, sizeof(x));
+        std::uint16_t sign = (x >> 16) & 0x8000;
+        x &= 0x7fffffff;
+        if(x < 0x38800000) // Below the smallest normal half, 2^-14
+            return {std::uint16_t(sign | std::lrint(std::abs(value) * 16777216.0f))};
+        if(x >= 0x477ff000) // Rounds past the largest half
+            return {std::uint16_t(sign | 0x7c00)};
+        // Rebias the exponent and round the dropped mantissa bits to nearest even
+        x += 0xc8000fff + ((x >> 13) & 1);
+        return {std::uint16_t(sign | (x >> 13))};
+    }
+    static float decode(Half value) {
+        std::uint32_t exponent = (value.bits >> 10) & 0x1f;
+        float magnitude;
+        if(exponent == 0) {
+            magnitude = (value.bits & 0x3ff) * (1.0f / 16777216.0f);
+        } else {
+            std::uint32_t x = (std::uint32_t(value.bits & 0x7fff) << 13) + (exponent == 0x1f ? 0x70000000 : 0x38000000);
+            std::memcpy(&magnitude, &x, sizeof(x));
+        }
+        return value.bits & 0x8000 ? -magnitude : magnitude;
+    }
+    static Half invert(Half value) { return encode(1.0f - decode(value)); }
+};
+
+template<>
+struct StorageTraits<std::uint16_t> {
+    static constexpr float SCALE = 65535.0f;
+    static std::uint16_t encode(float value) { return std::uint16_t(value * SCALE + 0.5f); }
+    static float decode(std::uint16_t value) { return value * (1.0f / SCALE); }
+    static std::uint16_t invert(std::uint16_t value) { return 65535 - value; }
+};
+
+template<>
+struct StorageTraits<std::uint8_t> {
+    static constexpr float SCALE = 255.0f;
+    static std::uint8_t encode(float value) { return std::uint8_t(value * SCALE + 0.5f); }
+    static float decode(std::uint8_t value) { return value * (1.0f / SCALE); }
+    static std::uint8_t invert(std::uint8_t value) { return 255 - value; }
+};
+
+
+/**
+ * Calls a function with a value of the storage type, so it can be specialized per type
+ * 
+ * @param storage the storage type
+ * @param fn generic function taking a value of the storage type
+ */
+template<typename Function>
+void visitStorage(WGStorage storage, Function fn) {
+    switch(storage) {
+        case WGStorage::Half:
+            fn(Half{});
+            break;
+        case WGStorage::UInt16:
+            fn(std::uint16_t{});
+            break;
+        case WGStorage::UInt8:
+            fn(std::uint8_t{});
+            break;
+        default:
+            fn(float{});
+            break;
+    }
+}
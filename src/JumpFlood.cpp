@@ -0,0 +1,95 @@
+/**
+ * @file JumpFlood.cpp
+ * 
+ * JumpFlood implementation file
+ */
+#include "JumpFlood.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "Parallel.h"
+
+
+/**
+ * Runs one flooding pass over a range of rows
+ * 
+ * Seeds are packed as (y << 16) | x so no divisions are needed in the inner loop.
+ * 
+ * @param src nearest packed seeds from the previous pass
+ * @param dst out: nearest packed seeds after this pass
+ * @param width the width of the grid
+ * @param height the height of the grid
+ * @param step distance to the sampled neighbours
+ * @param y0 first row to process
+ * @param y1 one past the last row to process
+ */
+static void jumpFloodPass(const int *src, int *dst, int width, int height, int step, int y0, int y1) {
+    for(int y = y0; y < y1; ++y) {
+        for(int x = 0; x < width; ++x) {
+            int best = src[y * width + x];
+            int bestDistance = std::numeric_limits<int>::max();
+            if(best >= 0) {
+                int dx = (best & 0xFFFF) - x, dy = (best >> 16) - y;
+                bestDistance = dx * dx + dy * dy;
+            }
+            for(int ny = y - step; ny <= y + step; ny += step) {
+                if(ny < 0 || ny >= height)
+                    continue;
+                for(int nx = x - step; nx <= x + step; nx += step) {
+                    if(nx < 0 || nx >= width)
+                        continue;
+                    int seed = src[ny * width + nx];
+                    if(seed < 0)
+                        continue;
+                    int dx = (seed & 0xFFFF) - x, dy = (seed >> 16) - y;
+                    int distance = dx * dx + dy * dy;
+                    if(distance < bestDistance || (distance == bestDistance && seed < best)) {
+                        best = seed;
+                        bestDistance = distance;
+                    }
+                }
+            }
+            dst[y * width + x] = best;
+        }
+    }
+}
+
+void jumpFlood(int *feature, int width, int height, int threads, int reach) {
+    int *buffer = new int[width * height];
+    int *src = feature, *dst = buffer;
+    for(int i = 0; i < width * height; ++i) {
+        if(feature[i] >= 0)
+            feature[i] = ((feature[i] / width) << 16) | (feature[i] % width);
+    }
+
+    // Steps of s, s / 2, ..., 1 carry a seed up to 2s - 1 cells along each axis
+    int limit = std::max(width, height);
+    if(reach > 0)
+        limit = std::min(limit, reach + 1);
+    int step = 1;
+    while(step * 2 < limit)
+        step *= 2;
+
+    // Halving steps followed by one more unit pass (JFA+1) to fix most remaining errors
+    bool extraPass = true;
+    while(step > 0) {
+        parallelFor(height, threads, [&](int y0, int y1) {
+            jumpFloodPass(src, dst, width, height, step, y0, y1);
+        });
+        std::swap(src, dst);
+        if(step == 1 && extraPass)
+            extraPass = false;
+        else
+            step /= 2;
+    }
+
+    for(int i = 0; i < width * height; ++i) {
+        if(src[i] >= 0)
+            feature[i] = (src[i] >> 16) * width + (src[i] & 0xFFFF);
+        else
+            feature[i] = -1;
+    }
+    delete[] buffer;
+}
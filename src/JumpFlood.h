@@ -0,0 +1,23 @@
+/**
+ * @file JumpFlood.h
+ * 
+ * JumpFlood header file
+ */
+#pragma once
+
+
+/**
+ * Approximates the nearest seed cell of every grid cell with the jump flooding algorithm
+ * 
+ * Runs passes with halving step sizes plus one extra unit pass, each pass reading the
+ * previous one so rows are split freely across threads. The first step is the smallest
+ * power of two reaching the given distance, so every cell within reach of a seed (in either
+ * axis) ends up with some seed, though not always the nearest one.
+ * 
+ * @param feature in: own index (y * width + x) for seed cells and -1 otherwise, out: index of the nearest seed found
+ * @param width the width of the grid, below 65536
+ * @param height the height of the grid, below 32768
+ * @param threads amount of threads to split rows across
+ * @param reach distance in cells seeds have to travel, 0 floods the whole grid
+ */
+void jumpFlood(int *feature, int width, int height, int threads, int reach = 0);
@@ -0,0 +1,75 @@
+/**
+ * @file Orientation.h
+ * 
+ * Orientation header file
+ */
+#pragma once
+
+
+/**
+ * Definition of the Orientation struct
+ * 
+ * One of the 8 symmetries of the square (the D4 group) as a view of a row by row buffer.
+ * Flips and transposes only change how indices are mapped, so an oriented tile is read
+ * straight from the unoriented buffer without any extra pass over it. Operations compose
+ * like the WalkingGradient ones they replace, applied in the same order.
+ */
+struct Orientation {
+    bool swapAxes = false;  // Applied to the buffer first
+    bool mirrorX = false;   // Then the view's columns are mirrored
+    bool mirrorY = false;   // And its rows
+
+
+    /**
+     * Flips the view around the Y axis
+     */
+    void flipX() {
+        mirrorX = !mirrorX;
+    }
+
+
+    /**
+     * Flips the view around the X axis
+     */
+    void flipY() {
+        mirrorY = !mirrorY;
+    }
+
+
+    /**
+     * Transposes the view like a 2D matrix
+     */
+    void transpose() {
+        swapAxes = !swapAxes;
+        bool mirror = mirrorX;
+        mirrorX = mirrorY;
+        mirrorY = mirror;
+    }
+
+
+    /**
+     * Gets the buffer index of the first pixel of a row of the view
+     * 
+     * @param y the row of the view
+     * @param width the width of the buffer
+     * @param height the height of the buffer
+     * @return index into the buffer
+     */
+    int rowStart(int y, int width, int height) const {
+        if(swapAxes)
+            return (mirrorY ? width - 1 - y : y) + (mirrorX ? (height - 1) * width : 0);
+        return (mirrorY ? height - 1 - y : y) * width + (mirrorX ? width - 1 : 0);
+    }
+
+
+    /**
+     * Gets the buffer index step from one pixel of a row of the view to the next
+     * 
+     * @param width the width of the buffer
+     * @return index step, negative when mirrored
+     */
+    int columnStep(int width) const {
+        int step = swapAxes ? width : 1;
+        return mirrorX ? -step : step;
+    }
+};
@@ -0,0 +1,39 @@
+/**
+ * @file Parallel.h
+ * 
+ * Parallel helper header file
+ */
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Splits the range [0, count) into contiguous chunks and runs them on separate threads
+ * 
+ * The calling thread runs the first chunk and joins the others before returning.
+ * 
+ * @param count size of the range
+ * @param threads amount of threads to use, values below 2 run everything on the calling thread
+ * @param fn function taking the begin and end of a chunk
+ */
+template<typename Function>
+void parallelFor(int count, int threads, Function fn) {
+    threads = std::max(1, std::min(threads, count));
+    if(threads == 1) {
+        fn(0, count);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    int chunk = (count + threads - 1) / threads;
+    for(int begin = chunk; begin < count; begin += chunk) {
+        workers.emplace_back(fn, begin, std::min(count, begin + chunk));
+    }
+    fn(0, std::min(count, chunk));
+    for(std::thread& worker : workers) {
+        worker.join();
+    }
+}
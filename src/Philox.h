@@ -0,0 +1,201 @@
+/**
+ * @file Philox.h
+ * 
+ * Philox header file
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+
+/**
+ * Definition of the Philox class
+ * 
+ * Philox4x32-10 counter-based random number generator by Salmon et al. Output block n of
+ * a stream is a pure function of (seed, stream, n), so every stream can be regenerated on
+ * its own, on any thread and in any order, with identical results. Normal values use our
+ * own Box-Muller transform, so they do not depend on the standard library's distributions.
+ */
+class Philox {
+    public:
+        using result_type = std::uint32_t;
+
+        /**
+         * Starts a stream at its first value
+         * 
+         * @param seed the run's seed, used as the key
+         * @param stream independent stream of the run, such as a tile id
+         */
+        Philox(std::uint64_t seed, std::uint32_t stream)
+            : key{std::uint32_t(seed), std::uint32_t(seed >> 32)}, counter{0, 0, stream, 0} {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        /**
+         * Gets the next 32 random bits of the stream
+         */
+        result_type operator()() {
+            if(used == 4) {
+                generateBlock();
+                used = 0;
+            }
+            return block[used++];
+        }
+
+
+        /**
+         * Gets a uniform value in (0, 1]
+         */
+        double uniform() {
+            return ((*this)() + 1.0) * (1.0 / 4294967296.0);
+        }
+
+
+        /**
+         * Gets a standard normal value
+         */
+        float normal() {
+            if(hasSpare) {
+                hasSpare = false;
+                return spare;
+            }
+            double radius = std::sqrt(-2.0 * std::log(uniform()));
+            double angle = 2.0 * 3.14159265358979323846 * uniform();
+            spare = (float)(radius * std::sin(angle));
+            hasSpare = true;
+            return (float)(radius * std::cos(angle));
+        }
+
+
+        /**
+         * Fills an array with standard normal values in one call
+         * 
+         * Whole output blocks are encrypted from consecutive counters and turned into
+         * normals by a branch-free Box-Muller transform with polynomial log, sine and
+         * cosine, so both loops vectorize. The values follow the stream from the next
+         * unused block on, but differ from calling normal() one at a time.
+         * 
+         * @param out out: the normal values
+         * @param count amount of values
+         */
+        void fillNormal(float *out, int count);
+
+    private:
+        std::uint32_t key[2];
+        std::uint32_t counter[4];   // 64-bit block index, stream, unused
+        std::uint32_t block[4];
+        int used = 4;
+        bool hasSpare = false;
+        float spare = 0.0f;
+
+        /**
+         * Encrypts a counter into an output block
+         * 
+         * Pure function of its inputs, so loops over independent counters vectorize.
+         */
+        static void encrypt(std::uint32_t c0, std::uint32_t c1, std::uint32_t c2, std::uint32_t c3,
+                            std::uint32_t k0, std::uint32_t k1, std::uint32_t *out) {
+            for(int round = 0; round < 10; ++round) {
+                std::uint64_t p0 = std::uint64_t(0xD2511F53) * c0;
+                std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c2;
+                std::uint32_t n0 = std::uint32_t(p1 >> 32) ^ c1 ^ k0;
+                std::uint32_t n2 = std::uint32_t(p0 >> 32) ^ c3 ^ k1;
+                c1 = std::uint32_t(p1);
+                c3 = std::uint32_t(p0);
+                c0 = n0;
+                c2 = n2;
+                k0 += 0x9E3779B9;
+                k1 += 0xBB67AE85;
+            }
+            out[0] = c0;
+            out[1] = c1;
+            out[2] = c2;
+            out[3] = c3;
+        }
+
+
+        /**
+         * Encrypts the counter into the next output block and advances the counter
+         */
+        void generateBlock() {
+            encrypt(counter[0], counter[1], counter[2], counter[3], key[0], key[1], block);
+            if(++counter[0] == 0)
+                ++counter[1];
+        }
+};
+
+
+/**
+ * Natural logarithm of a positive normal float, about 1e-7 relative error
+ */
+inline float philoxLog(float x) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    // Split into 2^e * m with m in [sqrt(0.5), sqrt(2))
+    std::uint32_t shifted = bits + (0x3f800000 - 0x3f3504f3);
+    int e = int(shifted >> 23) - 127;
+    bits = (shifted & 0x007fffff) + 0x3f3504f3;
+    float m;
+    std::memcpy(&m, &bits, sizeof(m));
+    // log(m) = 2 * atanh(s) with s = (m - 1) / (m + 1), |s| < 0.172
+    float s = (m - 1.0f) / (m + 1.0f), s2 = s * s;
+    float series = 1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f + s2 * (1.0f / 7.0f + s2 * (1.0f / 9.0f))));
+    return e * 0.693147180559945f + 2.0f * s * series;
+}
+
+/**
+ * Square root of a non-negative float without errno handling, so loops calling it vectorize
+ */
+inline float philoxSqrt(float x) {
+    // Reciprocal square root estimate refined by three Newton steps, exact at 0
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5f3759df - (bits >> 1);
+    float y;
+    std::memcpy(&y, &bits, sizeof(y));
+    for(int step = 0; step < 3; ++step) {
+        y = y * (1.5f - 0.5f * x * y * y);
+    }
+    return x * y;
+}
+
+inline void Philox::fillNormal(float *out, int count) {
+    if(count <= 0)
+        return;
+    int pairs = (count + 1) / 2, blocks = (pairs + 1) / 2;
+    std::vector<std::uint32_t> bits(blocks * 4);
+    for(int n = 0; n < blocks; ++n) {
+        std::uint64_t index = (std::uint64_t(counter[1]) << 32 | counter[0]) + n;
+        encrypt(std::uint32_t(index), std::uint32_t(index >> 32), counter[2], counter[3], key[0], key[1], &bits[n * 4]);
+    }
+    std::uint64_t next = (std::uint64_t(counter[1]) << 32 | counter[0]) + blocks;
+    counter[0] = std::uint32_t(next);
+    counter[1] = std::uint32_t(next >> 32);
+
+    std::vector<float> values(pairs * 2);
+    for(int i = 0; i < pairs; ++i) {
+        // 24-bit uniforms, u1 in (0, 1]
+        int b1 = int(bits[2 * i] >> 8), b2 = int(bits[2 * i + 1] >> 8);
+        float u1 = (b1 + 1) * (1.0f / 16777216.0f);
+        float radius = philoxSqrt(-2.0f * philoxLog(u1));
+
+        // Angle 2 * PI * b2 / 2^24 as a quadrant and a remainder in [-PI / 4, PI / 4]
+        int q = (b2 + (1 << 21)) >> 22;
+        float x = (b2 - (q << 22)) * (1.57079632679f / 4194304.0f), x2 = x * x;
+        float sine = x * (1.0f - x2 * (1.0f / 6.0f) * (1.0f - x2 * (1.0f / 20.0f) * (1.0f - x2 * (1.0f / 42.0f) * (1.0f - x2 * (1.0f / 72.0f)))));
+        float cosine = 1.0f - x2 * 0.5f * (1.0f - x2 * (1.0f / 12.0f) * (1.0f - x2 * (1.0f / 30.0f) * (1.0f - x2 * (1.0f / 56.0f))));
+        // Rotate by the quadrant with arithmetic instead of branches, q is random
+        float odd = float(q & 1), flipC = float((q + 1) & 2), flipS = float(q & 2);
+        float c = (cosine + odd * (sine - cosine)) * (1.0f - flipC);
+        float s = (sine + odd * (cosine - sine)) * (1.0f - flipS);
+        values[2 * i] = radius * c;
+        values[2 * i + 1] = radius * s;
+    }
+    std::copy(values.begin(), values.begin() + count, out);
+}
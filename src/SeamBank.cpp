@@ -0,0 +1,150 @@
+/**
+ * @file SeamBank.cpp
+ * 
+ * SeamBank implementation file
+ */
+#include "SeamBank.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "WalkingGradient.h"
+
+
+/**
+ * Gets the bytes of one record and its offsets, padded so every record starts 8-byte aligned
+ * 
+ * @param sampleCount offsets in the record
+ */
+static std::size_t recordStride(std::uint32_t sampleCount) {
+    return (sizeof(SeamBankRecord) + sampleCount * sizeof(float) + 7) & ~std::size_t(7);
+}
+
+SeamBank::~SeamBank() {
+    close();
+}
+
+void SeamBank::close() {
+    if(mapping == nullptr)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+#else
+    munmap(const_cast<unsigned char*>(mapping), size);
+#endif
+    mapping = nullptr;
+    size = 0;
+}
+
+bool SeamBank::open(const fs::path& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    HANDLE view = nullptr;
+    if(GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        view = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if(view == nullptr)
+        return false;
+    mapping = static_cast<const unsigned char*>(MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(view);
+    if(mapping == nullptr)
+        return false;
+    size = std::size_t(fileSize.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if(file < 0)
+        return false;
+    struct stat info;
+    void *view = MAP_FAILED;
+    if(fstat(file, &info) == 0 && info.st_size > 0)
+        view = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);  // The mapping keeps the file open
+    if(view == MAP_FAILED)
+        return false;
+    mapping = static_cast<const unsigned char*>(view);
+    size = info.st_size;
+#endif
+
+    // The header must match and the file must hold every record it announces
+    const SeamBankHeader *header = size >= sizeof(SeamBankHeader) ? &getHeader() : nullptr;
+    if(header == nullptr || std::memcmp(header->magic, "CTSB", 4) != 0 || header->version != VERSION
+       || header->seamCount == 0 || header->edgeSampleCount < 2 || header->cornerSampleCount < 2
+       || size < sizeof(SeamBankHeader) + header->seamCount * (recordStride(header->edgeSampleCount) + recordStride(header->cornerSampleCount))) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool SeamBank::write(const fs::path& path, const WGSettings& wgs, int count) {
+    WGSettings seamSettings = wgs;
+    seamSettings.isCorner = false;
+    int edgeSampleCount = WalkingGradient::getSeamSampleCount(seamSettings);
+    seamSettings.isCorner = true;
+    int cornerSampleCount = WalkingGradient::getSeamSampleCount(seamSettings);
+    if(count <= 0 || edgeSampleCount < 2 || cornerSampleCount < 2)
+        return false;
+
+    std::ofstream outf(path, std::ios::binary);
+    if(!outf)
+        return false;
+
+    SeamBankHeader header = SeamBankHeader();
+    std::memcpy(header.magic, "CTSB", 4);
+    header.version = VERSION;
+    header.seamCount = count;
+    header.edgeSampleCount = edgeSampleCount;
+    header.cornerSampleCount = cornerSampleCount;
+    header.seam = std::uint32_t(wgs.seam);
+    header.seamDetail = wgs.seamDetail;
+    header.variance = wgs.variance;
+    header.seed = wgs.seed;
+    outf.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Edge seams take the even streams and corner seams the odd ones, so no two share draws
+    for(int corner = 0; corner < 2; ++corner) {
+        seamSettings.isCorner = corner;
+        int sampleCount = corner ? cornerSampleCount : edgeSampleCount;
+        std::vector<unsigned char> buffer(recordStride(sampleCount), 0);
+        for(int i = 0; i < count; ++i) {
+            seamSettings.tile = 2 * i + corner;
+            SeamBankRecord record = {wgs.seed, seamSettings.tile, 0};
+            std::memcpy(buffer.data(), &record, sizeof(record));
+            WalkingGradient::generateSeamOffsets(seamSettings, reinterpret_cast<float*>(buffer.data() + sizeof(record)));
+            outf.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        }
+    }
+    return bool(outf);
+}
+
+const SeamBankHeader& SeamBank::getHeader() const {
+    return *reinterpret_cast<const SeamBankHeader*>(mapping);
+}
+
+const float* SeamBank::getOffsets(std::uint32_t index, bool isCorner, SeamBankRecord *record) const {
+    const SeamBankHeader& header = getHeader();
+    std::size_t edgeStride = recordStride(header.edgeSampleCount);
+    std::size_t offset = sizeof(SeamBankHeader) + std::size_t(index % header.seamCount)
+        * (isCorner ? recordStride(header.cornerSampleCount) : edgeStride);
+    if(isCorner)
+        offset += header.seamCount * edgeStride;
+    if(record != nullptr)
+        std::memcpy(record, mapping + offset, sizeof(SeamBankRecord));
+    return reinterpret_cast<const float*>(mapping + offset + sizeof(SeamBankRecord));
+}
@@ -0,0 +1,116 @@
+/**
+ * @file SeamBank.h
+ * 
+ * SeamBank header file
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+struct WGSettings;
+
+namespace fs = std::filesystem;
+
+
+/**
+ * Definition of the SeamBankHeader struct
+ * 
+ * Start of a seam bank file, followed by seamCount edge records and seamCount corner
+ * records. Each record is a SeamBankRecord followed by its offsets from seamHeight as
+ * floats. Values are stored in the byte order of the machine that wrote the bank.
+ */
+struct SeamBankHeader {
+    char magic[4];                  // "CTSB"
+    std::uint32_t version;
+    std::uint32_t seamCount;        // Seams of each kind
+    std::uint32_t edgeSampleCount;  // Offsets per edge seam, the sampleCount setting
+    std::uint32_t cornerSampleCount;// Offsets per corner seam
+    std::uint32_t seam;             // WGSeam the seams were generated with
+    std::uint32_t seamDetail;
+    float variance;
+    std::uint64_t seed;             // Seed the bank was generated with
+};
+
+
+/**
+ * Definition of the SeamBankRecord struct
+ * 
+ * Seed and random stream a banked seam was drawn from, so it can be regenerated
+ */
+struct SeamBankRecord {
+    std::uint64_t seed;
+    std::uint32_t stream;
+    std::uint32_t reserved;
+};
+
+
+/**
+ * Definition of the SeamBank class
+ * 
+ * Read-only, memory-mapped file of pre-generated edge and corner seams. Gradients given a
+ * bank copy a banked seam instead of generating one, so sampling costs one copy out of the
+ * page cache no matter the seam kind.
+ */
+class SeamBank {
+    public:
+        static constexpr std::uint32_t VERSION = 1;
+
+        SeamBank() = default;
+        SeamBank(const SeamBank&) = delete;
+        SeamBank& operator=(const SeamBank&) = delete;
+
+
+        /**
+         * Default destructor
+         * 
+         * Unmaps the bank file
+         */
+        virtual ~SeamBank();
+
+
+        /**
+         * Maps a seam bank file and checks its header
+         * 
+         * @param path the bank file
+         * @return true if the file is a complete bank of this version
+         */
+        bool open(const fs::path& path);
+
+
+        /**
+         * Generates seams with the given settings and writes them as a bank
+         * 
+         * Seam i is drawn from random stream 2i (edge) or 2i + 1 (corner) of the settings' seed.
+         * 
+         * @param path the bank file to write
+         * @param wgs walking gradient settings, isCorner and tile are overridden
+         * @param count amount of edge seams and of corner seams
+         * @return true if the file could be written
+         */
+        static bool write(const fs::path& path, const WGSettings& wgs, int count);
+
+
+        /**
+         * Gets the header of the mapped bank
+         */
+        const SeamBankHeader& getHeader() const;
+
+
+        /**
+         * Gets the offsets from seamHeight of a banked seam
+         * 
+         * @param index the seam, wrapped around the seam count
+         * @param isCorner if true, gets a corner seam, otherwise an edge seam
+         * @param record out: seed and stream the seam was drawn from, may be nullptr
+         * @return edgeSampleCount or cornerSampleCount offsets
+         */
+        const float* getOffsets(std::uint32_t index, bool isCorner, SeamBankRecord *record = nullptr) const;
+
+    private:
+        const unsigned char *mapping = nullptr;
+        std::size_t size = 0;
+
+        void close();
+};
@@ -0,0 +1,62 @@
+/**
+ * @file SeamFunction.cpp
+ * 
+ * SeamFunction implementation file
+ */
+#include "SeamFunction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+void fourierSeam(float *offsets, int count, int harmonics, float deviation, Philox& generator) {
+    // sin(k * a) follows sin((k + 1) * a) = 2 * cos(a) * sin(k * a) - sin((k - 1) * a), so the
+    // terms are accumulated one harmonic at a time over all points, a loop the compiler vectorizes
+    std::vector<float> previous(count, 0.0f), current(count), twiceCos(count);
+    for(int i = 0; i < count; ++i) {
+        double angle = M_PI * i / (count - 1.0);
+        current[i] = (float)std::sin(angle);
+        twiceCos[i] = (float)(2.0 * std::cos(angle));
+        offsets[i] = 0.0f;
+    }
+    for(int k = 1; k <= harmonics; ++k) {
+        float amplitude = generator.normal() * deviation * (float)(std::sqrt(2.0) / (k * M_PI));
+        for(int i = 0; i < count; ++i) {
+            offsets[i] += amplitude * current[i];
+            float next = twiceCos[i] * current[i] - previous[i];
+            previous[i] = current[i];
+            current[i] = next;
+        }
+    }
+
+    // The recurrence drifts slightly from 0 at the far end
+    offsets[0] = 0.0f;
+    offsets[count - 1] = 0.0f;
+}
+
+void noiseSeam(float *offsets, int count, int cells, float deviation, Philox& generator) {
+    cells = std::max(1, cells);
+
+    std::vector<float> gradients(cells + 1);
+    for(int j = 0; j < cells; ++j) {
+        gradients[j] = generator.normal();
+    }
+    gradients[cells] = gradients[0];
+
+    // Unit normal gradients give noise with an rms of about 0.244, scaled to the walk's rms
+    // over the whole seam, deviation / sqrt(6)
+    float amplitude = deviation / (std::sqrt(6.0f) * 0.244f);
+    float scale = cells / (count - 1.0f);
+    for(int i = 0; i < count; ++i) {
+        float u = i * scale;
+        int j = std::min((int)u, cells - 1);
+        float f = u - j;
+        float fade = f * f * f * (f * (f * 6.0f - 15.0f) + 10.0f);
+        offsets[i] = amplitude * (gradients[j] * f * (1.0f - fade) + gradients[j + 1] * (f - 1.0f) * fade);
+    }
+}
@@ -0,0 +1,51 @@
+/**
+ * @file SeamFunction.h
+ * 
+ * SeamFunction header file
+ */
+#pragma once
+
+#include "Philox.h"
+
+
+/**
+ * Definition of the WGSeam enum
+ * 
+ * How the seam's offsets from seamHeight are generated
+ */
+enum class WGSeam {
+    Walk,       // Random walk pinned to end where it started
+    Fourier,    // Truncated sine series of a random walk pinned at both ends
+    Noise       // Periodic 1D gradient noise, zero at both ends
+};
+
+
+/**
+ * Evaluates a random truncated sine series at evenly spaced points
+ * 
+ * The series is the Karhunen-Loeve expansion of a Brownian bridge, sum of
+ * Z_k * sqrt(2) * sin(k * PI * t) / (k * PI) with standard normal Z_k, so it has the
+ * statistics of the random walk seam but starts and ends at 0 by construction.
+ * 
+ * @param offsets out: seam offsets at t = i / (count - 1)
+ * @param count amount of points, at least 2
+ * @param harmonics amount of sine terms, sets the seam's detail
+ * @param deviation standard deviation of the walk's whole length, half of it is reached mid seam
+ * @param generator random engine for the coefficients
+ */
+void fourierSeam(float *offsets, int count, int harmonics, float deviation, Philox& generator);
+
+
+/**
+ * Evaluates random periodic 1D gradient noise at evenly spaced points
+ * 
+ * Lattice points lie at t = j / cells and the noise is 0 on each of them, so both ends
+ * of the seam are 0. The first and last gradient are equal, so slopes match across tiles.
+ * 
+ * @param offsets out: seam offsets at t = i / (count - 1)
+ * @param count amount of points, at least 2
+ * @param cells amount of lattice cells, sets the seam's detail
+ * @param deviation standard deviation of the walk's whole length, the noise is scaled to match its spread
+ * @param generator random engine for the gradients
+ */
+void noiseSeam(float *offsets, int count, int cells, float deviation, Philox& generator);
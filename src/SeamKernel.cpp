@@ -0,0 +1,134 @@
+/**
+ * @file SeamKernel.cpp
+ * 
+ * SeamKernel implementation file
+ */
+#include "SeamKernel.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SEAM_KERNEL_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SEAM_KERNEL_WIDTH 4
+#else
+#define SEAM_KERNEL_WIDTH 1
+#endif
+
+SeamKernel::SeamKernel(const glm::vec2 *samples, int sampleCount) : count(sampleCount - 1) {
+    paddedCount = (count + SEAM_KERNEL_WIDTH - 1) / SEAM_KERNEL_WIDTH * SEAM_KERNEL_WIDTH;
+    ax = new float[paddedCount];
+    ay = new float[paddedCount];
+    dx = new float[paddedCount];
+    dy = new float[paddedCount];
+    invLengthSq = new float[paddedCount];
+
+    for(int i = 0; i < count; ++i) {
+        ax[i] = samples[i].x;
+        ay[i] = samples[i].y;
+        dx[i] = samples[i + 1].x - samples[i].x;
+        dy[i] = samples[i + 1].y - samples[i].y;
+        float lengthSq = dx[i] * dx[i] + dy[i] * dy[i];
+        invLengthSq[i] = lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f;
+    }
+
+    // Padding lanes are points so far away they never win
+    for(int i = count; i < paddedCount; ++i) {
+        ax[i] = ay[i] = 1e30f;
+        dx[i] = dy[i] = invLengthSq[i] = 0.0f;
+    }
+}
+
+SeamKernel::~SeamKernel() {
+    delete[] invLengthSq;
+    delete[] dy;
+    delete[] dx;
+    delete[] ay;
+    delete[] ax;
+}
+
+float SeamKernel::closestSquared(const glm::vec2& v, int& segment) const {
+    float best = std::numeric_limits<float>::infinity();
+    int bestIndex = 0;
+
+#if SEAM_KERNEL_WIDTH == 8
+    __m256 px = _mm256_set1_ps(v.x), py = _mm256_set1_ps(v.y);
+    __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    __m256 bestLanes = _mm256_set1_ps(best);
+    __m256 indexLanes = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7), bestIndexLanes = zero;
+    __m256 step = _mm256_set1_ps(8.0f);
+    for(int i = 0; i < paddedCount; i += 8) {
+        __m256 wx = _mm256_sub_ps(px, _mm256_loadu_ps(ax + i));
+        __m256 wy = _mm256_sub_ps(py, _mm256_loadu_ps(ay + i));
+        __m256 sx = _mm256_loadu_ps(dx + i), sy = _mm256_loadu_ps(dy + i);
+        __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(wx, sx), _mm256_mul_ps(wy, sy)), _mm256_loadu_ps(invLengthSq + i));
+        t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+        __m256 ex = _mm256_sub_ps(wx, _mm256_mul_ps(t, sx));
+        __m256 ey = _mm256_sub_ps(wy, _mm256_mul_ps(t, sy));
+        __m256 d = _mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey));
+        __m256 closer = _mm256_cmp_ps(d, bestLanes, _CMP_LT_OQ);
+        bestLanes = _mm256_blendv_ps(bestLanes, d, closer);
+        bestIndexLanes = _mm256_blendv_ps(bestIndexLanes, indexLanes, closer);
+        indexLanes = _mm256_add_ps(indexLanes, step);
+    }
+    float lanes[8], indices[8];
+    _mm256_storeu_ps(lanes, bestLanes);
+    _mm256_storeu_ps(indices, bestIndexLanes);
+#elif SEAM_KERNEL_WIDTH == 4
+    __m128 px = _mm_set1_ps(v.x), py = _mm_set1_ps(v.y);
+    __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    __m128 bestLanes = _mm_set1_ps(best);
+    __m128 indexLanes = _mm_setr_ps(0, 1, 2, 3), bestIndexLanes = zero;
+    __m128 step = _mm_set1_ps(4.0f);
+    for(int i = 0; i < paddedCount; i += 4) {
+        __m128 wx = _mm_sub_ps(px, _mm_loadu_ps(ax + i));
+        __m128 wy = _mm_sub_ps(py, _mm_loadu_ps(ay + i));
+        __m128 sx = _mm_loadu_ps(dx + i), sy = _mm_loadu_ps(dy + i);
+        __m128 t = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(wx, sx), _mm_mul_ps(wy, sy)), _mm_loadu_ps(invLengthSq + i));
+        t = _mm_min_ps(_mm_max_ps(t, zero), one);
+        __m128 ex = _mm_sub_ps(wx, _mm_mul_ps(t, sx));
+        __m128 ey = _mm_sub_ps(wy, _mm_mul_ps(t, sy));
+        __m128 d = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+        __m128 closer = _mm_cmplt_ps(d, bestLanes);
+        bestLanes = _mm_or_ps(_mm_and_ps(closer, d), _mm_andnot_ps(closer, bestLanes));
+        bestIndexLanes = _mm_or_ps(_mm_and_ps(closer, indexLanes), _mm_andnot_ps(closer, bestIndexLanes));
+        indexLanes = _mm_add_ps(indexLanes, step);
+    }
+    float lanes[4], indices[4];
+    _mm_storeu_ps(lanes, bestLanes);
+    _mm_storeu_ps(indices, bestIndexLanes);
+#else
+    float lanes[1] = {best}, indices[1] = {0.0f};
+    for(int i = 0; i < paddedCount; ++i) {
+        float wx = v.x - ax[i], wy = v.y - ay[i];
+        float t = std::clamp((wx * dx[i] + wy * dy[i]) * invLengthSq[i], 0.0f, 1.0f);
+        float ex = wx - t * dx[i], ey = wy - t * dy[i];
+        float d = ex * ex + ey * ey;
+        if(d < lanes[0]) {
+            lanes[0] = d;
+            indices[0] = (float)i;
+        }
+    }
+#endif
+
+    // Lowest index wins ties, like a scalar scan in segment order
+    for(int lane = 0; lane < SEAM_KERNEL_WIDTH; ++lane) {
+        int index = (int)indices[lane];
+        if(lanes[lane] < best || (lanes[lane] == best && index < bestIndex)) {
+            best = lanes[lane];
+            bestIndex = index;
+        }
+    }
+    segment = bestIndex + 1;
+    return best;
+}
+
+glm::vec2 SeamKernel::closestPoint(const glm::vec2& v, int segment) const {
+    int i = segment - 1;
+    float wx = v.x - ax[i], wy = v.y - ay[i];
+    float t = std::clamp((wx * dx[i] + wy * dy[i]) * invLengthSq[i], 0.0f, 1.0f);
+    return {ax[i] + t * dx[i], ay[i] + t * dy[i]};
+}
@@ -0,0 +1,63 @@
+/**
+ * @file SeamKernel.h
+ * 
+ * SeamKernel header file
+ */
+#pragma once
+
+#include <glm/vec2.hpp>
+
+
+/**
+ * Definition of the SeamKernel class
+ * 
+ * Structure of arrays copy of a seam's segments with a vectorized closest segment search.
+ * Uses AVX2 (8 segments) or SSE2 (4 segments) when compiled for them, scalar code otherwise.
+ * 
+ * Distances are compared squared and only the winner needs a square root. The projection
+ * differs from glm::closestPointOnLine, so distances agree with the scalar reference within
+ * 4 ULP of the largest of the pixel coordinates and the distance, not bit for bit.
+ */
+class SeamKernel {
+    public:
+
+        /**
+         * Copies the segments between consecutive samples into aligned lanes
+         * 
+         * @param samples euclidean seam samples
+         * @param sampleCount amount of seam samples
+         */
+        SeamKernel(const glm::vec2 *samples, int sampleCount);
+
+
+        /**
+         * Default destructor
+         * 
+         * Cleans up segment lanes
+         */
+        virtual ~SeamKernel();
+
+
+        /**
+         * Finds the squared distance from a point to the closest seam segment
+         * 
+         * @param v the point to query
+         * @param segment out: index of the closest segment, which ends at samples[segment]
+         * @return squared distance to the closest segment
+         */
+        float closestSquared(const glm::vec2& v, int& segment) const;
+
+
+        /**
+         * Projects a point onto a segment
+         * 
+         * @param v the point to project
+         * @param segment index of the segment, which ends at samples[segment]
+         * @return the closest point on the segment
+         */
+        glm::vec2 closestPoint(const glm::vec2& v, int segment) const;
+
+    private:
+        float *ax, *ay, *dx, *dy, *invLengthSq;
+        int count, paddedCount;
+};
@@ -0,0 +1,273 @@
+/**
+ * @file SeamPath.cpp
+ * 
+ * SeamPath implementation file
+ */
+#include "SeamPath.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <string>
+
+#ifndef M_PI_2
+#define M_PI_2 (3.14159265358979323846 / 2.0)
+#endif
+
+/**
+ * Line segments each Bezier curve of an SVG path is flattened to
+ */
+static constexpr int CURVE_STEPS = 16;
+
+
+/**
+ * Reads the next number of an SVG attribute, skipping separators
+ * 
+ * @param text the attribute value
+ * @param i in/out: position in text, moved past the number
+ * @param value out: the number
+ * @return true if a number was read
+ */
+static bool readNumber(const std::string& text, std::size_t& i, float& value) {
+    while(i < text.size() && (std::isspace((unsigned char)text[i]) || text[i] == ','))
+        ++i;
+    if(i >= text.size())
+        return false;
+    const char *begin = text.c_str() + i;
+    char *end;
+    value = std::strtof(begin, &end);
+    if(end == begin)
+        return false;
+    i += end - begin;
+    return true;
+}
+
+/**
+ * Appends a cubic Bezier curve, without its first point, as line segments
+ */
+static void flattenCubic(std::vector<float>& points, float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3) {
+    for(int s = 1; s <= CURVE_STEPS; ++s) {
+        float t = s / (float)CURVE_STEPS, u = 1.0f - t;
+        float a = u * u * u, b = 3.0f * u * u * t, c = 3.0f * u * t * t, d = t * t * t;
+        points.push_back(a * x0 + b * x1 + c * x2 + d * x3);
+        points.push_back(a * y0 + b * y1 + c * y2 + d * y3);
+    }
+}
+
+/**
+ * Flattens the d attribute of an SVG path into its points
+ * 
+ * @param d the path data
+ * @param points out: x and y of every point, interleaved
+ * @return false if the data holds an unsupported command, such as arcs
+ */
+static bool parsePathData(const std::string& d, std::vector<float>& points) {
+    float x = 0.0f, y = 0.0f, startX = 0.0f, startY = 0.0f;
+    float controlX = 0.0f, controlY = 0.0f;     // Last curve control point, reflected by S and T
+    char command = 0, previous = 0;
+    std::size_t i = 0;
+    while(true) {
+        while(i < d.size() && (std::isspace((unsigned char)d[i]) || d[i] == ','))
+            ++i;
+        if(i >= d.size())
+            return true;
+        if(std::isalpha((unsigned char)d[i]))
+            command = d[i++];
+        else if(command == 0)
+            return false;
+
+        bool relative = std::islower((unsigned char)command);
+        float ox = relative ? x : 0.0f, oy = relative ? y : 0.0f;
+        float v[6];
+        auto read = [&](int count) {
+            for(int k = 0; k < count; ++k) {
+                if(!readNumber(d, i, v[k]))
+                    return false;
+            }
+            return true;
+        };
+
+        switch(std::toupper((unsigned char)command)) {
+            case 'M':
+                if(!read(2))
+                    return false;
+                x = startX = ox + v[0];
+                y = startY = oy + v[1];
+                points.push_back(x);
+                points.push_back(y);
+                command = relative ? 'l' : 'L';    // Further pairs are line segments
+                break;
+            case 'L':
+                if(!read(2))
+                    return false;
+                x = ox + v[0];
+                y = oy + v[1];
+                points.push_back(x);
+                points.push_back(y);
+                break;
+            case 'H':
+                if(!read(1))
+                    return false;
+                x = ox + v[0];
+                points.push_back(x);
+                points.push_back(y);
+                break;
+            case 'V':
+                if(!read(1))
+                    return false;
+                y = oy + v[0];
+                points.push_back(x);
+                points.push_back(y);
+                break;
+            case 'C':
+            case 'S': {
+                bool smooth = std::toupper((unsigned char)command) == 'S';
+                if(!read(smooth ? 4 : 6))
+                    return false;
+                float x1 = ox + v[0], y1 = oy + v[1];
+                if(smooth) {
+                    bool follows = std::toupper((unsigned char)previous) == 'C' || std::toupper((unsigned char)previous) == 'S';
+                    x1 = follows ? 2.0f * x - controlX : x;
+                    y1 = follows ? 2.0f * y - controlY : y;
+                    std::copy_backward(v, v + 4, v + 6);
+                }
+                controlX = ox + v[2];
+                controlY = oy + v[3];
+                flattenCubic(points, x, y, x1, y1, controlX, controlY, ox + v[4], oy + v[5]);
+                x = ox + v[4];
+                y = oy + v[5];
+                break;
+            }
+            case 'Q':
+            case 'T': {
+                bool smooth = std::toupper((unsigned char)command) == 'T';
+                if(!read(smooth ? 2 : 4))
+                    return false;
+                float qx = ox + v[0], qy = oy + v[1];
+                if(smooth) {
+                    bool follows = std::toupper((unsigned char)previous) == 'Q' || std::toupper((unsigned char)previous) == 'T';
+                    qx = follows ? 2.0f * x - controlX : x;
+                    qy = follows ? 2.0f * y - controlY : y;
+                    std::copy(v, v + 2, v + 2);
+                }
+                // A quadratic curve is the cubic with controls two thirds towards its control point
+                float ex = ox + v[2], ey = oy + v[3];
+                flattenCubic(points, x, y, x + 2.0f / 3.0f * (qx - x), y + 2.0f / 3.0f * (qy - y),
+                             ex + 2.0f / 3.0f * (qx - ex), ey + 2.0f / 3.0f * (qy - ey), ex, ey);
+                controlX = qx;
+                controlY = qy;
+                x = ex;
+                y = ey;
+                break;
+            }
+            case 'Z':
+                x = startX;
+                y = startY;
+                points.push_back(x);
+                points.push_back(y);
+                break;
+            default:
+                return false;
+        }
+        previous = command;
+        if(std::toupper((unsigned char)command) == 'Z')
+            command = 0;    // Numbers may not follow a closed path
+    }
+}
+
+/**
+ * Reads the points of the first path or polyline of an SVG file
+ */
+static bool loadSvgPath(const std::string& text, std::vector<float>& points) {
+    std::smatch match;
+    static const std::regex element("<(path|polyline)\\b[^>]*?\\s(d|points)\\s*=\\s*(\"([^\"]*)\"|'([^']*)')");
+    if(!std::regex_search(text, match, element))
+        return false;
+    std::string value = match[4].matched ? match[4].str() : match[5].str();
+    if(match[1] == "path")
+        return parsePathData(value, points);
+
+    std::size_t i = 0;
+    float number;
+    while(readNumber(value, i, number))
+        points.push_back(number);
+    points.resize(points.size() & ~std::size_t(1));
+    return true;
+}
+
+bool loadSeamPath(const fs::path& path, std::vector<float>& points) {
+    std::ifstream inf(path);
+    points.clear();
+    if(!inf)
+        return false;
+
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    if(extension == ".svg") {
+        std::stringstream text;
+        text << inf.rdbuf();
+        if(!loadSvgPath(text.str(), points))
+            points.clear();
+        return points.size() >= 4;
+    }
+
+    std::string line;
+    while(std::getline(inf, line)) {
+        std::replace(line.begin(), line.end(), ';', ',');
+        std::size_t i = 0;
+        float x, y;
+        // Header and comment lines do not start with a number
+        if(readNumber(line, i, x) && readNumber(line, i, y)) {
+            points.push_back(x);
+            points.push_back(y);
+        }
+    }
+    return points.size() >= 4;
+}
+
+/**
+ * Resamples a polyline given as (parameter, value) pairs at evenly spaced parameters
+ * 
+ * @param keys parameter and value of every point, interleaved, reversed if the parameter decreases
+ * @param offsets out: value - base at parameter i * span / (count - 1)
+ * @param count amount of samples
+ * @param span parameter of the last sample
+ * @param base value the offsets are measured from
+ */
+static void resamplePolyline(std::vector<float>& keys, float *offsets, int count, float span, float base) {
+    int n = keys.size() / 2;
+    if(keys[0] > keys[2 * (n - 1)]) {
+        for(int k = 0; k < n / 2; ++k) {
+            std::swap(keys[2 * k], keys[2 * (n - 1 - k)]);
+            std::swap(keys[2 * k + 1], keys[2 * (n - 1 - k) + 1]);
+        }
+    }
+
+    int k = 0;
+    for(int i = 0; i < count; ++i) {
+        float t = i * span / (count - 1);
+        while(k < n - 2 && keys[2 * (k + 1)] < t)
+            ++k;
+        float t0 = keys[2 * k], t1 = keys[2 * (k + 1)];
+        float w = t1 > t0 ? std::clamp((t - t0) / (t1 - t0), 0.0f, 1.0f) : 0.0f;
+        offsets[i] = keys[2 * k + 1] + (keys[2 * k + 3] - keys[2 * k + 1]) * w - base;
+    }
+}
+
+void resampleEdgePath(const std::vector<float>& points, float *offsets, int count, float width, float seamHeight) {
+    std::vector<float> keys(points.begin(), points.end());
+    resamplePolyline(keys, offsets, count, width, seamHeight);
+}
+
+void resampleCornerPath(const std::vector<float>& points, float *offsets, int count, float seamHeight) {
+    std::vector<float> keys(points.size());
+    for(std::size_t k = 0; k + 1 < points.size(); k += 2) {
+        keys[k] = std::atan2(points[k + 1], points[k]);
+        keys[k + 1] = std::sqrt(points[k] * points[k] + points[k + 1] * points[k + 1]);
+    }
+    resamplePolyline(keys, offsets, count, M_PI_2, seamHeight);
+}
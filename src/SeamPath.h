@@ -0,0 +1,54 @@
+/**
+ * @file SeamPath.h
+ * 
+ * SeamPath header file
+ */
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+
+/**
+ * Reads a hand-authored seam polyline
+ * 
+ * Files ending in .svg take the first path's d attribute (M, L, H, V, C, S, Q, T and Z
+ * commands, curves are flattened) or the first polyline's points. Any other file is read as
+ * CSV: one x, y point per line, separated by commas, semicolons or whitespace, lines that
+ * do not start with a number are skipped. Coordinates are pixels of the unflipped tile:
+ * edge seams run from x = 0 to the tile width, corner seams circle the top left corner.
+ * 
+ * @param path the seam file
+ * @param points out: x and y of every point, interleaved
+ * @return true if the file held at least two points
+ */
+bool loadSeamPath(const fs::path& path, std::vector<float>& points);
+
+
+/**
+ * Resamples an edge seam polyline at evenly spaced columns
+ * 
+ * The polyline is read as a function of x, points beyond its ends take the end's height.
+ * 
+ * @param points x and y of every point, interleaved
+ * @param offsets out: seam offsets from seamHeight at x = i * width / (count - 1)
+ * @param count amount of seam samples
+ * @param width the tile width
+ * @param seamHeight height the offsets are measured from
+ */
+void resampleEdgePath(const std::vector<float>& points, float *offsets, int count, float width, float seamHeight);
+
+
+/**
+ * Resamples a corner seam polyline at evenly spaced angles around the tile's top left corner
+ * 
+ * The polyline is read as a radius for every angle, angles beyond its ends take the end's radius.
+ * 
+ * @param points x and y of every point, interleaved
+ * @param offsets out: seam radius offsets from seamHeight at angle i * (PI / 2) / (count - 1)
+ * @param count amount of seam samples
+ * @param seamHeight radius the offsets are measured from
+ */
+void resampleCornerPath(const std::vector<float>& points, float *offsets, int count, float seamHeight);
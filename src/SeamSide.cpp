@@ -0,0 +1,154 @@
+/**
+ * @file SeamSide.cpp
+ * 
+ * SeamSide implementation file
+ */
+#include "SeamSide.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/gtx/closest_point.hpp>
+
+SeamSide::SeamSide(const glm::vec2 *samples, int sampleCount, bool isCorner, float slack)
+    : isCorner(isCorner), valid(sampleCount > 1), slack(slack), seamLo(0.0f), seamHi(0.0f), offset(0), bins(1), sectors(1) {
+    // Edge bin k holds the seam over columns [k + offset, k + offset + 1], corner bin k one sector
+    if(isCorner) {
+        sectors = bins = std::max(1, sampleCount - 1);
+    } else if(valid) {
+        float minX = samples[0].x, maxX = samples[0].x;
+        for(int i = 1; i < sampleCount; ++i) {
+            minX = std::min(minX, samples[i].x);
+            maxX = std::max(maxX, samples[i].x);
+        }
+        offset = (int)std::floor(minX);
+        bins = (int)std::floor(maxX) - offset + 1;
+    }
+
+    std::vector<float> binLo(bins, std::numeric_limits<float>::max());
+    std::vector<float> binHi(bins, std::numeric_limits<float>::lowest());
+    for(int i = 1; valid && i < sampleCount; ++i) {
+        glm::vec2 a = samples[i - 1], b = samples[i];
+        int k0, k1;
+        float segmentLo, segmentHi;
+        if(isCorner) {
+            // Sectors are only monotonic in the angle while x + y stays positive
+            if(a.x + a.y <= 0.0f || b.x + b.y <= 0.0f) {
+                valid = false;
+                break;
+            }
+            k0 = std::min(sector(a), sector(b));
+            k1 = std::max(sector(a), sector(b));
+            segmentLo = glm::length(glm::closestPointOnLine(glm::vec2(0.0f, 0.0f), a, b));
+            segmentHi = std::max(glm::length(a), glm::length(b));
+        } else {
+            k0 = (int)std::floor(std::min(a.x, b.x)) - offset;
+            k1 = (int)std::floor(std::max(a.x, b.x)) - offset;
+            segmentLo = std::min(a.y, b.y);
+            segmentHi = std::max(a.y, b.y);
+        }
+        for(int k = k0; k <= k1; ++k) {
+            binLo[k] = std::min(binLo[k], segmentLo);
+            binHi[k] = std::max(binHi[k], segmentHi);
+        }
+    }
+    if(!valid)
+        return;
+    seamLo = *std::min_element(binLo.begin(), binLo.end());
+    seamHi = *std::max_element(binHi.begin(), binHi.end());
+
+    // The seam is continuous, so it crosses every bin between its ends and none is empty,
+    // except corner sectors before the first or after the last one it reaches
+    if(isCorner) {
+        int first = 0, last = bins - 1;
+        while(binLo[first] > binHi[first])
+            ++first;
+        while(binLo[last] > binHi[last])
+            --last;
+        offset = first;
+        bins = last - first + 1;
+        binLo.assign(binLo.begin() + first, binLo.begin() + last + 1);
+        binHi.assign(binHi.begin() + first, binHi.begin() + last + 1);
+    }
+
+    // Sparse tables: level l holds the extremes of 2^l bins starting at each bin
+    logs.assign(bins + 1, 0);
+    for(int n = 2; n <= bins; ++n)
+        logs[n] = logs[n / 2] + 1;
+    lo.assign(1, binLo);
+    hi.assign(1, binHi);
+    for(int l = 1; (1 << l) <= bins; ++l) {
+        int count = bins - (1 << l) + 1, half = 1 << (l - 1);
+        lo.emplace_back(count);
+        hi.emplace_back(count);
+        for(int k = 0; k < count; ++k) {
+            lo[l][k] = std::min(lo[l - 1][k], lo[l - 1][k + half]);
+            hi[l][k] = std::max(hi[l - 1][k], hi[l - 1][k + half]);
+        }
+    }
+}
+
+int SeamSide::sector(const glm::vec2& p) const {
+    // Only called with x + y > 0
+    float t = p.y / (p.x + p.y);
+    return std::clamp((int)std::floor(sectors * t), 0, sectors - 1);
+}
+
+void SeamSide::range(int k0, int k1, float& rangeLo, float& rangeHi) const {
+    k0 = std::max(k0, 0);
+    k1 = std::min(k1, bins - 1);
+    int l = logs[k1 - k0 + 1];
+    rangeLo = std::min(lo[l][k0], lo[l][k1 - (1 << l) + 1]);
+    rangeHi = std::max(hi[l][k1 - (1 << l) + 1], hi[l][k0]);
+}
+
+int SeamSide::side(const glm::vec2& v) const {
+    if(!valid)
+        return 0;
+
+    float rangeLo, rangeHi;
+    if(!isCorner) {
+        // Pixels past the whole seam are decided without a lookup
+        if(v.y > seamHi + slack)
+            return 1;
+        if(v.y < seamLo - slack)
+            return -1;
+        int k = (int)std::floor(v.x) - offset;
+        if(k < 0 || k >= bins)
+            return 0;
+        // A seam point in the pixel's own column is at most a column away horizontally
+        float reach = std::max(std::abs(v.y - lo[0][k]), std::abs(v.y - hi[0][k])) + 1.0f + slack;
+        range((int)std::floor(v.x - reach) - offset, (int)std::floor(v.x + reach) - offset, rangeLo, rangeHi);
+        if(rangeHi < v.y - slack)
+            return 1;
+        if(rangeLo > v.y + slack)
+            return -1;
+        return 0;
+    }
+
+    float rSq = v.x * v.x + v.y * v.y;
+    if(rSq > (seamHi + slack) * (seamHi + slack))
+        return 1;
+    if(seamLo - slack > 0.0f && rSq < (seamLo - slack) * (seamLo - slack))
+        return -1;
+    if(v.x + v.y <= 0.0f)
+        return 0;
+    int k = sector(v) - offset;
+    if(k < 0 || k >= bins)
+        return 0;
+    // A seam point in the pixel's own sector is within its radius difference plus the arc
+    // of the sector, which spans at most 2 / sectors radians
+    float r = std::sqrt(rSq);
+    float reach = std::max(std::abs(r - lo[0][k]), std::abs(r - hi[0][k]))
+                + std::max(r, hi[0][k]) * 2.0f / sectors + slack;
+    // Sectors of the square around the pixel, y / (x + y) grows with y and shrinks with x
+    float sum = v.x + v.y;
+    int k0 = v.y - reach > 0.0f ? (int)std::floor(sectors * (v.y - reach) / sum) : 0;
+    int k1 = v.x - reach > 0.0f ? (int)std::floor(sectors * (v.y + reach) / sum) : sectors - 1;
+    range(k0 - offset, k1 - offset, rangeLo, rangeHi);
+    if(rangeHi < r - slack)
+        return 1;
+    if(rangeLo > r + slack)
+        return -1;
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file SeamSide.h
+ * 
+ * SeamSide header file
+ */
+#pragma once
+
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+
+/**
+ * Definition of the SeamSide class
+ * 
+ * Decides which side of a seam a pixel lies on without finding its closest seam point.
+ * The seam's height range is kept per pixel column (edge), or its radius range per angular
+ * sector (corner), with range tables over them. Any seam point in the pixel's own column or
+ * sector bounds how far away its closest point can be, and if every seam point in that reach
+ * lies below or inside the pixel, or every one above or outside it, the closest one does too.
+ */
+class SeamSide {
+    public:
+
+        /**
+         * Builds the column or sector ranges of a seam polyline
+         * 
+         * @param samples euclidean seam samples
+         * @param sampleCount amount of seam samples
+         * @param isCorner true for a corner seam around the origin, false for an edge seam along x
+         * @param slack distance the seam measured by the pixel function may be off the polyline
+         */
+        SeamSide(const glm::vec2 *samples, int sampleCount, bool isCorner, float slack);
+
+
+        /**
+         * Finds the side of the seam a pixel lies on, by the reference closest point rule
+         * 
+         * @param v the pixel position
+         * @return 1 above (edge) or outside (corner) of the seam, -1 below or inside, 0 if undecided
+         */
+        int side(const glm::vec2& v) const;
+
+    private:
+        bool isCorner, valid;
+        float slack, seamLo, seamHi;
+        int offset, bins, sectors;
+        std::vector<int> logs;
+        std::vector<std::vector<float>> lo, hi;
+
+        /**
+         * Gets the corner sector of a point, sectors are uniform in y / (x + y)
+         */
+        int sector(const glm::vec2& p) const;
+
+        /**
+         * Gets the lowest and highest seam position over bins k0 to k1, clamped to the table
+         */
+        void range(int k0, int k1, float& rangeLo, float& rangeHi) const;
+};
@@ -0,0 +1,228 @@
+/**
+ * @file SegmentGrid.cpp
+ * 
+ * SegmentGrid implementation file
+ */
+#include "SegmentGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/gtx/closest_point.hpp>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+SegmentGrid::SegmentGrid(const glm::vec2 *samples, int sampleCount, bool reversed, bool polar)
+    : samples(samples), sampleCount(sampleCount), reversed(reversed), polar(polar), sectorRadius(nullptr), sectorEdge(nullptr) {
+    if(polar)
+        this->polar = buildSectors();
+
+    if(!this->polar) {
+        glm::vec2 lo = samples[0], hi = samples[0];
+        float length = 0.0f;
+        for(int i = 1; i < sampleCount; ++i) {
+            lo = {std::min(lo.x, samples[i].x), std::min(lo.y, samples[i].y)};
+            hi = {std::max(hi.x, samples[i].x), std::max(hi.y, samples[i].y)};
+            length += glm::distance(samples[i - 1], samples[i]);
+        }
+
+        // Cells a few segments long keep buckets small without visiting many empty cells
+        cellSize = std::max(8.0f, 4.0f * length / std::max(1, sampleCount - 1));
+        origin = lo;
+        cellsX = (int)((hi.x - lo.x) / cellSize) + 1;
+        cellsY = (int)((hi.y - lo.y) / cellSize) + 1;
+    }
+
+    // Count segments per cell, then fill buckets in index order
+    cellStart = new int[cellsX * cellsY + 1]();
+    for(int pass = 0; pass < 2; ++pass) {
+        int *fill = pass ? new int[cellsX * cellsY]() : nullptr;
+        for(int i = 1; i < sampleCount; ++i) {
+            int x0, x1, y0, y1;
+            if(this->polar) {
+                float a0 = std::atan2(samples[i - 1].y, samples[i - 1].x), a1 = std::atan2(samples[i].y, samples[i].x);
+                x0 = std::min(cellsX - 1, (int)((std::min(a0, a1) - angleOrigin) / sectorAngle));
+                x1 = std::min(cellsX - 1, (int)((std::max(a0, a1) - angleOrigin) / sectorAngle));
+                y0 = y1 = 0;
+            } else {
+                x0 = (int)((std::min(samples[i - 1].x, samples[i].x) - origin.x) / cellSize);
+                x1 = (int)((std::max(samples[i - 1].x, samples[i].x) - origin.x) / cellSize);
+                y0 = (int)((std::min(samples[i - 1].y, samples[i].y) - origin.y) / cellSize);
+                y1 = (int)((std::max(samples[i - 1].y, samples[i].y) - origin.y) / cellSize);
+            }
+            for(int cy = y0; cy <= y1; ++cy) {
+                for(int cx = x0; cx <= x1; ++cx) {
+                    int cell = cy * cellsX + cx;
+                    if(pass == 0) {
+                        ++cellStart[cell + 1];
+                    } else {
+                        cellSegments[cellStart[cell] + fill[cell]++] = i;
+                    }
+                }
+            }
+            if(this->polar && pass == 0) {
+                float nearest = glm::length(glm::closestPointOnLine(glm::vec2(0.0f, 0.0f), samples[i - 1], samples[i]));
+                float farthest = std::max(glm::length(samples[i - 1]), glm::length(samples[i]));
+                for(int cx = x0; cx <= x1; ++cx) {
+                    sectorRadius[6 * cx] = std::min(sectorRadius[6 * cx], nearest);
+                    sectorRadius[6 * cx + 1] = std::max(sectorRadius[6 * cx + 1], farthest);
+                }
+            }
+        }
+        if(this->polar && pass == 0) {
+            // Ranges of the sectors before and after each one bound a whole walk in that direction
+            for(int cx = 0; cx < cellsX; ++cx) {
+                sectorRadius[6 * cx + 2] = std::min(sectorRadius[6 * cx], cx > 0 ? sectorRadius[6 * cx - 4] : sectorRadius[6 * cx]);
+                sectorRadius[6 * cx + 3] = std::max(sectorRadius[6 * cx + 1], cx > 0 ? sectorRadius[6 * cx - 3] : sectorRadius[6 * cx + 1]);
+            }
+            for(int cx = cellsX - 1; cx >= 0; --cx) {
+                sectorRadius[6 * cx + 4] = std::min(sectorRadius[6 * cx], cx < cellsX - 1 ? sectorRadius[6 * cx + 10] : sectorRadius[6 * cx]);
+                sectorRadius[6 * cx + 5] = std::max(sectorRadius[6 * cx + 1], cx < cellsX - 1 ? sectorRadius[6 * cx + 11] : sectorRadius[6 * cx + 1]);
+            }
+        }
+        if(pass == 0) {
+            for(int c = 0; c < cellsX * cellsY; ++c)
+                cellStart[c + 1] += cellStart[c];
+            cellSegments = new int[cellStart[cellsX * cellsY]];
+        } else {
+            delete[] fill;
+        }
+    }
+}
+
+SegmentGrid::~SegmentGrid() {
+    delete[] cellSegments;
+    delete[] cellStart;
+    delete[] sectorRadius;
+    delete[] sectorEdge;
+}
+
+bool SegmentGrid::buildSectors() {
+    float lo = std::numeric_limits<float>::infinity(), hi = -lo;
+    for(int i = 1; i < sampleCount; ++i) {
+        float a0 = std::atan2(samples[i - 1].y, samples[i - 1].x), a1 = std::atan2(samples[i].y, samples[i].x);
+        float nearest = glm::length(glm::closestPointOnLine(glm::vec2(0.0f, 0.0f), samples[i - 1], samples[i]));
+        // A segment spans the angles between its ends unless it crosses the negative x axis
+        if(std::abs(a1 - a0) >= float(M_PI) || nearest < 1e-3f)
+            return false;
+        lo = std::min({lo, a0, a1});
+        hi = std::max({hi, a0, a1});
+    }
+
+    // Sectors about four segments wide, like square cells a few segments long
+    cellsX = std::max(1, (sampleCount - 1) / 4);
+    cellsY = 1;
+    angleOrigin = lo;
+    sectorAngle = std::max(hi - lo, 1e-6f) / cellsX;
+    sectorRadius = new float[6 * cellsX];
+    for(int cx = 0; cx < cellsX; ++cx) {
+        sectorRadius[6 * cx] = std::numeric_limits<float>::infinity();
+        sectorRadius[6 * cx + 1] = -std::numeric_limits<float>::infinity();
+    }
+    sectorEdge = new glm::vec2[cellsX + 1];
+    for(int cx = 0; cx <= cellsX; ++cx) {
+        float angle = angleOrigin + cx * sectorAngle;
+        sectorEdge[cx] = {std::cos(angle), std::sin(angle)};
+    }
+    return true;
+}
+
+void SegmentGrid::visitCell(int cx, int cy, const glm::vec2& v, float& distance, glm::vec2& closestPoint, int& best) const {
+    int cell = cy * cellsX + cx;
+    for(int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+        int i = cellSegments[k];
+        glm::vec2 currentPoint = reversed ? glm::closestPointOnLine(v, samples[i], samples[i - 1])
+                                          : glm::closestPointOnLine(v, samples[i - 1], samples[i]);
+        float d = glm::distance(v, currentPoint);
+        // Ties go to the lowest index, like a scan with a strict comparison
+        if(d < distance || (d == distance && best >= 0 && i < best)) {
+            distance = d;
+            closestPoint = currentPoint;
+            best = i;
+        }
+    }
+}
+
+int SegmentGrid::closest(const glm::vec2& v, float& distance, glm::vec2& closestPoint) const {
+    if(polar)
+        return closestPolar(v, distance, closestPoint);
+    int best = -1;
+    int cx = (int)std::floor((v.x - origin.x) / cellSize);
+    int cy = (int)std::floor((v.y - origin.y) / cellSize);
+
+    // Rings of cells around the query cell, starting at the first ring touching the grid
+    int r = std::max({0, -cx, cx - (cellsX - 1), -cy, cy - (cellsY - 1)});
+    int rMax = std::max({cx, cellsX - 1 - cx, cy, cellsY - 1 - cy});
+    // Distance from v to the nearest side of its own cell
+    float fx = v.x - origin.x - cx * cellSize, fy = v.y - origin.y - cy * cellSize;
+    float margin = std::min({fx, cellSize - fx, fy, cellSize - fy});
+    for(; r <= rMax; ++r) {
+        // Every point in ring r is at least (r - 1) cells past that side
+        if(r > 0 && (r - 1) * cellSize + margin > distance)
+            break;
+        int y0 = std::max(0, cy - r), y1 = std::min(cellsY - 1, cy + r);
+        int x0 = std::max(0, cx - r), x1 = std::min(cellsX - 1, cx + r);
+        for(int y = y0; y <= y1; ++y) {
+            if(y == cy - r || y == cy + r) {
+                for(int x = x0; x <= x1; ++x)
+                    visitCell(x, y, v, distance, closestPoint, best);
+            } else {
+                if(cx - r >= 0)
+                    visitCell(cx - r, y, v, distance, closestPoint, best);
+                if(r > 0 && cx + r < cellsX)
+                    visitCell(cx + r, y, v, distance, closestPoint, best);
+            }
+        }
+    }
+    return best;
+}
+
+
+int SegmentGrid::closestPolar(const glm::vec2& v, float& distance, glm::vec2& closestPoint) const {
+    int best = -1;
+    float radiusSq = glm::dot(v, v), angle = std::atan2(v.y, v.x);
+
+    // Squared distance from v to the points between radius r0 and r1 along a direction
+    auto rayGapSq = [&](const glm::vec2& direction, float r0, float r1) {
+        glm::vec2 gap = v - std::clamp(glm::dot(direction, v), r0, r1) * direction;
+        return glm::dot(gap, gap);
+    };
+    // Slack keeps rounding in the bounds from ruling out a segment at the current distance
+    auto beyond = [&](float gapSq) {
+        float reach = distance + 1e-3f;
+        return gapSq > reach * reach;
+    };
+
+    int start = std::clamp((int)std::floor((angle - angleOrigin) / sectorAngle), 0, cellsX - 1);
+    // Sectors farther from v's angle are farther around as long as no gap wraps past PI
+    bool rightMonotone = angleOrigin + cellsX * sectorAngle - angle <= float(M_PI);
+    bool leftMonotone = angle - angleOrigin <= float(M_PI);
+    // Walk right of the start sector, then left of it
+    for(int step = 1; step >= -1; step -= 2) {
+        for(int cx = step > 0 ? start : start - 1; cx >= 0 && cx < cellsX; cx += step) {
+            const float *range = sectorRadius + 6 * cx;
+            float from = angleOrigin + cx * sectorAngle, to = from + sectorAngle;
+            // The sectors from here on in the walk's direction hold nothing or are all too far
+            if(step > 0 && angle < from && rightMonotone && (range[4] > range[5] || beyond(rayGapSq(sectorEdge[cx], range[4], range[5]))))
+                break;
+            if(step < 0 && angle > to && leftMonotone && (range[2] > range[3] || beyond(rayGapSq(sectorEdge[cx + 1], range[2], range[3]))))
+                break;
+            if(range[0] > range[1])
+                continue;
+            float gapSq;
+            if(angle < from) {
+                gapSq = rayGapSq(sectorEdge[cx], range[0], range[1]);
+            } else if(angle > to) {
+                gapSq = rayGapSq(sectorEdge[cx + 1], range[0], range[1]);
+            } else {
+                float radius = std::sqrt(radiusSq), gap = std::max({0.0f, range[0] - radius, radius - range[1]});
+                gapSq = gap * gap;
+            }
+            if(!beyond(gapSq))
+                visitCell(cx, 0, v, distance, closestPoint, best);
+        }
+    }
+    return best;
+}
\ No newline at end of file
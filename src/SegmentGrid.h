@@ -0,0 +1,87 @@
+/**
+ * @file SegmentGrid.h
+ * 
+ * SegmentGrid header file
+ */
+#pragma once
+
+#include <glm/vec2.hpp>
+
+
+/**
+ * Definition of the SegmentGrid class
+ * 
+ * Uniform grid bucketing the segments of a seam polyline for closest segment queries
+ * 
+ * Corner seams run around the origin at a roughly constant radius, so a square cell search
+ * from a pixel far inside or outside of them reaches the whole seam. Polar grids bucket
+ * the segments by angle instead and search outward from the pixel's angle.
+ */
+class SegmentGrid {
+    public:
+
+        /**
+         * Builds the grid over the segments between consecutive samples
+         * 
+         * @param samples euclidean seam samples, must outlive the grid
+         * @param sampleCount amount of seam samples
+         * @param reversed if true, segment i is evaluated from samples[i] to samples[i - 1]
+         * @param polar if true, bucket segments by their angle around the origin, falls back to
+         *              square cells if the seam winds past the negative x axis or touches the origin
+         */
+        SegmentGrid(const glm::vec2 *samples, int sampleCount, bool reversed = false, bool polar = false);
+
+
+        /**
+         * Default destructor
+         * 
+         * Cleans up cell buckets
+         */
+        virtual ~SegmentGrid();
+
+
+        /**
+         * Finds the closest point on the seam to a point
+         * 
+         * Only visits cells that can hold a segment closer than the current best distance.
+         * Results match a linear scan over all segments in index order, including ties.
+         * 
+         * @param v the point to query
+         * @param distance in: best distance found so far, out: distance to the closest point
+         * @param closestPoint out: the closest point, untouched if nothing beats distance
+         * @return index of the closest segment, -1 if nothing beats distance
+         */
+        int closest(const glm::vec2& v, float& distance, glm::vec2& closestPoint) const;
+
+    private:
+        const glm::vec2 *samples;
+        int sampleCount;
+        bool reversed;
+        glm::vec2 origin;
+        float cellSize;
+        int cellsX, cellsY;
+        int *cellStart, *cellSegments;
+        bool polar;
+        float angleOrigin, sectorAngle;     // Polar cells are sectors of sectorAngle from angleOrigin
+        float *sectorRadius;                // Radius ranges of each sector's segments, of the sectors up to it and from it on
+        glm::vec2 *sectorEdge;              // Unit direction of the start of each sector and the end of the last
+
+        /**
+         * Tests every segment in a cell against the current best
+         */
+        void visitCell(int cx, int cy, const glm::vec2& v, float& distance, glm::vec2& closestPoint, int& best) const;
+
+
+        /**
+         * Builds polar cells, one row of angular sectors
+         * 
+         * @return false if the seam winds past the negative x axis or touches the origin
+         */
+        bool buildSectors();
+
+
+        /**
+         * Finds the closest point on the seam by walking sectors outward from the point's angle
+         */
+        int closestPolar(const glm::vec2& v, float& distance, glm::vec2& closestPoint) const;
+};
@@ -0,0 +1,128 @@
+/**
+ * @file SplineSeam.cpp
+ * 
+ * SplineSeam implementation file
+ */
+#include "SplineSeam.h"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/geometric.hpp>
+#include <limits>
+
+static constexpr int NEWTON_STEPS = 4;
+
+SplineSeam::SplineSeam(const glm::vec2 *samples, int sampleCount, int segments) {
+    segments = std::clamp(segments, 1, sampleCount - 1);
+    std::vector<glm::vec2> points(segments + 1);
+    for(int j = 0; j <= segments; ++j) {
+        points[j] = samples[(int)std::lround(j * (sampleCount - 1.0) / segments)];
+    }
+
+    c0.resize(segments);
+    c1.resize(segments);
+    c2.resize(segments);
+    c3.resize(segments);
+    boundsLo.resize(segments);
+    boundsHi.resize(segments);
+    for(int i = 0; i < segments; ++i) {
+        // The ends are extended by mirroring their neighbours
+        glm::vec2 p1 = points[i], p2 = points[i + 1];
+        glm::vec2 p0 = i > 0 ? points[i - 1] : 2.0f * p1 - p2;
+        glm::vec2 p3 = i + 2 <= segments ? points[i + 2] : 2.0f * p2 - p1;
+        c0[i] = p1;
+        c1[i] = 0.5f * (p2 - p0);
+        c2[i] = 0.5f * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3);
+        c3[i] = 0.5f * (3.0f * p1 - p0 - 3.0f * p2 + p3);
+
+        // The equivalent Bezier control points bound the segment
+        glm::vec2 b1 = p1 + (p2 - p0) / 6.0f, b2 = p2 - (p3 - p1) / 6.0f;
+        boundsLo[i] = {std::min({p1.x, b1.x, b2.x, p2.x}), std::min({p1.y, b1.y, b2.y, p2.y})};
+        boundsHi[i] = {std::max({p1.x, b1.x, b2.x, p2.x}), std::max({p1.y, b1.y, b2.y, p2.y})};
+    }
+}
+
+glm::vec2 SplineSeam::evaluate(int i, float t) const {
+    return c0[i] + t * (c1[i] + t * (c2[i] + t * c3[i]));
+}
+
+glm::vec2 SplineSeam::derivative(int i, float t) const {
+    return c1[i] + t * (2.0f * c2[i] + t * 3.0f * c3[i]);
+}
+
+float SplineSeam::closestOnSegment(int i, const glm::vec2& v, glm::vec2& closestPoint, float& t) const {
+    t = 0.0f;
+    float tSq = std::numeric_limits<float>::infinity();
+    for(int k = 0; k <= 4; ++k) {
+        glm::vec2 d = evaluate(i, k * 0.25f) - v;
+        float dSq = glm::dot(d, d);
+        if(dSq < tSq) {
+            tSq = dSq;
+            t = k * 0.25f;
+        }
+    }
+
+    // Newton on the derivative of the squared distance, (C(t) - v) . C'(t) = 0
+    for(int step = 0; step < NEWTON_STEPS; ++step) {
+        glm::vec2 d = evaluate(i, t) - v;
+        glm::vec2 d1 = derivative(i, t);
+        glm::vec2 d2 = 2.0f * c2[i] + t * 6.0f * c3[i];
+        float slope = glm::dot(d, d1), curvature = glm::dot(d1, d1) + glm::dot(d, d2);
+        if(curvature <= 0.0f)
+            break;
+        t = std::clamp(t - slope / curvature, 0.0f, 1.0f);
+    }
+
+    closestPoint = evaluate(i, t);
+    glm::vec2 d = closestPoint - v;
+    return glm::dot(d, d);
+}
+
+float SplineSeam::boundsGapSquared(int i, const glm::vec2& v) const {
+    float gapX = std::max({boundsLo[i].x - v.x, v.x - boundsHi[i].x, 0.0f});
+    float gapY = std::max({boundsLo[i].y - v.y, v.y - boundsHi[i].y, 0.0f});
+    return gapX * gapX + gapY * gapY;
+}
+
+float SplineSeam::closest(const glm::vec2& v, glm::vec2& closestPoint, glm::vec2& tangent) const {
+    int segments = c0.size(), nearest = 0;
+    float nearestGapSq = std::numeric_limits<float>::infinity();
+    for(int i = 0; i < segments; ++i) {
+        float gapSq = boundsGapSquared(i, v);
+        if(gapSq < nearestGapSq) {
+            nearestGapSq = gapSq;
+            nearest = i;
+        }
+    }
+
+    // The segment with the nearest bounds usually wins, so it goes first to prune the rest
+    float bestT, t;
+    float bestSq = closestOnSegment(nearest, v, closestPoint, bestT);
+    int best = nearest;
+    for(int i = 0; i < segments; ++i) {
+        if(i == nearest || boundsGapSquared(i, v) >= bestSq)
+            continue;
+        glm::vec2 point;
+        float dSq = closestOnSegment(i, v, point, t);
+        if(dSq < bestSq) {
+            bestSq = dSq;
+            closestPoint = point;
+            best = i;
+            bestT = t;
+        }
+    }
+    tangent = derivative(best, bestT);
+    return std::sqrt(bestSq);
+}
+
+std::vector<glm::vec2> SplineSeam::tessellate(int perSegment) const {
+    std::vector<glm::vec2> polyline;
+    polyline.reserve(c0.size() * perSegment + 1);
+    for(size_t i = 0; i < c0.size(); ++i) {
+        for(int k = 0; k < perSegment; ++k) {
+            polyline.push_back(evaluate(i, k / (float)perSegment));
+        }
+    }
+    polyline.push_back(evaluate(c0.size() - 1, 1.0f));
+    return polyline;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file SplineSeam.h
+ * 
+ * SplineSeam header file
+ */
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <vector>
+
+
+/**
+ * Definition of the SplineSeam class
+ * 
+ * Uniform Catmull-Rom spline through a few points of a seam polyline, with closest point
+ * queries solved by Newton iterations on each cubic segment
+ */
+class SplineSeam {
+    public:
+
+        /**
+         * Fits the spline through evenly spaced seam samples, including both ends
+         * 
+         * @param samples euclidean seam samples
+         * @param sampleCount amount of seam samples
+         * @param segments amount of cubic segments, at most sampleCount - 1
+         */
+        SplineSeam(const glm::vec2 *samples, int sampleCount, int segments);
+
+
+        /**
+         * Finds the closest point on the spline to a point
+         * 
+         * The segment with the nearest control polygon bounding box is measured first, then
+         * segments whose bounds are farther than the best distance are skipped. Each measured
+         * segment starts from the best of five evenly spaced parameters and refines it with
+         * Newton steps.
+         * 
+         * @param v the point to query
+         * @param closestPoint out: the closest point
+         * @param tangent out: the spline's derivative at the closest point, along the seam's samples
+         * @return distance to the closest point
+         */
+        float closest(const glm::vec2& v, glm::vec2& closestPoint, glm::vec2& tangent) const;
+
+
+        /**
+         * Samples the spline as a polyline
+         * 
+         * @param perSegment amount of polyline segments per cubic segment
+         * @return polyline samples, segments * perSegment + 1 of them
+         */
+        std::vector<glm::vec2> tessellate(int perSegment) const;
+
+    private:
+        // Segment i is c0 + c1 * t + c2 * t^2 + c3 * t^3 for t in [0, 1]
+        std::vector<glm::vec2> c0, c1, c2, c3;
+        std::vector<glm::vec2> boundsLo, boundsHi;
+
+        glm::vec2 evaluate(int i, float t) const;
+        glm::vec2 derivative(int i, float t) const;
+
+
+        /**
+         * Finds the squared distance from a point to the bounds of one cubic segment
+         */
+        float boundsGapSquared(int i, const glm::vec2& v) const;
+
+
+        /**
+         * Finds the squared distance from a point to one cubic segment and the parameter t of its closest point
+         */
+        float closestOnSegment(int i, const glm::vec2& v, glm::vec2& closestPoint, float& t) const;
+};
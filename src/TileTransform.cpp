@@ -0,0 +1,285 @@
+/**
+ * @file TileTransform.cpp
+ * 
+ * TileTransform implementation file
+ */
+#include "TileTransform.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TILE_TRANSFORM_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TILE_TRANSFORM_WIDTH 4
+#else
+#define TILE_TRANSFORM_WIDTH 1
+#endif
+
+/**
+ * Side of the square blocks a transpose is walked in, 64x64 floats fill 16 KiB of cache
+ */
+static constexpr int TRANSPOSE_BLOCK = 64;
+
+/**
+ * Side of the blocks transposed in registers
+ */
+static constexpr int KERNEL_SIZE = 8;
+
+
+/**
+ * Transposes an 8x8 block between two row by row buffers
+ * 
+ * @param src first element of the block to read
+ * @param srcStride elements per row of src
+ * @param dst out: first element of the transposed block
+ * @param dstStride elements per row of dst
+ */
+static void transposeKernel(const std::uint32_t *src, int srcStride, std::uint32_t *dst, int dstStride) {
+#if TILE_TRANSFORM_WIDTH == 8
+    // Values are only moved, so float lanes carry any 32-bit pattern unchanged
+    const float *s = reinterpret_cast<const float*>(src);
+    float *d = reinterpret_cast<float*>(dst);
+    __m256 r0 = _mm256_loadu_ps(s), r1 = _mm256_loadu_ps(s + srcStride);
+    __m256 r2 = _mm256_loadu_ps(s + 2 * srcStride), r3 = _mm256_loadu_ps(s + 3 * srcStride);
+    __m256 r4 = _mm256_loadu_ps(s + 4 * srcStride), r5 = _mm256_loadu_ps(s + 5 * srcStride);
+    __m256 r6 = _mm256_loadu_ps(s + 6 * srcStride), r7 = _mm256_loadu_ps(s + 7 * srcStride);
+
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)), u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)), u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    // Each 128-bit half now holds a 4x4 block, the halves are exchanged last
+    _mm256_storeu_ps(d, _mm256_permute2f128_ps(u0, u4, 0x20));
+    _mm256_storeu_ps(d + dstStride, _mm256_permute2f128_ps(u1, u5, 0x20));
+    _mm256_storeu_ps(d + 2 * dstStride, _mm256_permute2f128_ps(u2, u6, 0x20));
+    _mm256_storeu_ps(d + 3 * dstStride, _mm256_permute2f128_ps(u3, u7, 0x20));
+    _mm256_storeu_ps(d + 4 * dstStride, _mm256_permute2f128_ps(u0, u4, 0x31));
+    _mm256_storeu_ps(d + 5 * dstStride, _mm256_permute2f128_ps(u1, u5, 0x31));
+    _mm256_storeu_ps(d + 6 * dstStride, _mm256_permute2f128_ps(u2, u6, 0x31));
+    _mm256_storeu_ps(d + 7 * dstStride, _mm256_permute2f128_ps(u3, u7, 0x31));
+#elif TILE_TRANSFORM_WIDTH == 4
+    const float *s = reinterpret_cast<const float*>(src);
+    float *d = reinterpret_cast<float*>(dst);
+    for(int by = 0; by < KERNEL_SIZE; by += 4) {
+        for(int bx = 0; bx < KERNEL_SIZE; bx += 4) {
+            const float *block = s + by * srcStride + bx;
+            __m128 r0 = _mm_loadu_ps(block), r1 = _mm_loadu_ps(block + srcStride);
+            __m128 r2 = _mm_loadu_ps(block + 2 * srcStride), r3 = _mm_loadu_ps(block + 3 * srcStride);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            float *out = d + bx * dstStride + by;
+            _mm_storeu_ps(out, r0);
+            _mm_storeu_ps(out + dstStride, r1);
+            _mm_storeu_ps(out + 2 * dstStride, r2);
+            _mm_storeu_ps(out + 3 * dstStride, r3);
+        }
+    }
+#else
+    for(int y = 0; y < KERNEL_SIZE; ++y) {
+        for(int x = 0; x < KERNEL_SIZE; ++x) {
+            dst[x * dstStride + y] = src[y * srcStride + x];
+        }
+    }
+#endif
+}
+
+static void transposeKernel(const std::uint16_t *src, int srcStride, std::uint16_t *dst, int dstStride) {
+#if TILE_TRANSFORM_WIDTH > 1
+    // An 8x8 block of 16-bit values is eight registers, interleaved three times
+    __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + srcStride));
+    __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * srcStride));
+    __m128i a3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * srcStride));
+    __m128i a4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * srcStride));
+    __m128i a5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 5 * srcStride));
+    __m128i a6 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 6 * srcStride));
+    __m128i a7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 7 * srcStride));
+
+    __m128i b0 = _mm_unpacklo_epi16(a0, a1), b1 = _mm_unpackhi_epi16(a0, a1);
+    __m128i b2 = _mm_unpacklo_epi16(a2, a3), b3 = _mm_unpackhi_epi16(a2, a3);
+    __m128i b4 = _mm_unpacklo_epi16(a4, a5), b5 = _mm_unpackhi_epi16(a4, a5);
+    __m128i b6 = _mm_unpacklo_epi16(a6, a7), b7 = _mm_unpackhi_epi16(a6, a7);
+
+    __m128i c0 = _mm_unpacklo_epi32(b0, b2), c1 = _mm_unpackhi_epi32(b0, b2);
+    __m128i c2 = _mm_unpacklo_epi32(b1, b3), c3 = _mm_unpackhi_epi32(b1, b3);
+    __m128i c4 = _mm_unpacklo_epi32(b4, b6), c5 = _mm_unpackhi_epi32(b4, b6);
+    __m128i c6 = _mm_unpacklo_epi32(b5, b7), c7 = _mm_unpackhi_epi32(b5, b7);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi64(c0, c4));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + dstStride), _mm_unpackhi_epi64(c0, c4));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * dstStride), _mm_unpacklo_epi64(c1, c5));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * dstStride), _mm_unpackhi_epi64(c1, c5));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * dstStride), _mm_unpacklo_epi64(c2, c6));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 5 * dstStride), _mm_unpackhi_epi64(c2, c6));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 6 * dstStride), _mm_unpacklo_epi64(c3, c7));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 7 * dstStride), _mm_unpackhi_epi64(c3, c7));
+#else
+    for(int y = 0; y < KERNEL_SIZE; ++y) {
+        for(int x = 0; x < KERNEL_SIZE; ++x) {
+            dst[x * dstStride + y] = src[y * srcStride + x];
+        }
+    }
+#endif
+}
+
+static void transposeKernel(const std::uint8_t *src, int srcStride, std::uint8_t *dst, int dstStride) {
+#if TILE_TRANSFORM_WIDTH > 1
+    // Rows of 8 bytes fill half a register, interleaving them leaves two columns per register
+    __m128i a0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+    __m128i a1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + srcStride));
+    __m128i a2 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 2 * srcStride));
+    __m128i a3 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 3 * srcStride));
+    __m128i a4 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 4 * srcStride));
+    __m128i a5 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 5 * srcStride));
+    __m128i a6 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 6 * srcStride));
+    __m128i a7 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + 7 * srcStride));
+
+    __m128i b0 = _mm_unpacklo_epi8(a0, a1), b1 = _mm_unpacklo_epi8(a2, a3);
+    __m128i b2 = _mm_unpacklo_epi8(a4, a5), b3 = _mm_unpacklo_epi8(a6, a7);
+
+    __m128i c0 = _mm_unpacklo_epi16(b0, b1), c1 = _mm_unpackhi_epi16(b0, b1);
+    __m128i c2 = _mm_unpacklo_epi16(b2, b3), c3 = _mm_unpackhi_epi16(b2, b3);
+
+    __m128i d[4] = {
+        _mm_unpacklo_epi32(c0, c2), _mm_unpackhi_epi32(c0, c2),
+        _mm_unpacklo_epi32(c1, c3), _mm_unpackhi_epi32(c1, c3)
+    };
+    for(int i = 0; i < 4; ++i) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 2 * i * dstStride), d[i]);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + (2 * i + 1) * dstStride), _mm_srli_si128(d[i], 8));
+    }
+#else
+    for(int y = 0; y < KERNEL_SIZE; ++y) {
+        for(int x = 0; x < KERNEL_SIZE; ++x) {
+            dst[x * dstStride + y] = src[y * srcStride + x];
+        }
+    }
+#endif
+}
+
+/**
+ * Transposes a buffer block by block, the partial 8x8 blocks at its right and bottom
+ * borders are copied one element at a time
+ */
+template<typename T>
+static void transposeBlocked(const T *src, T *dst, int width, int height) {
+    for(int y0 = 0; y0 < height; y0 += TRANSPOSE_BLOCK) {
+        int y1 = std::min(y0 + TRANSPOSE_BLOCK, height);
+        int yKernel = y0 + (y1 - y0) / KERNEL_SIZE * KERNEL_SIZE;
+        for(int x0 = 0; x0 < width; x0 += TRANSPOSE_BLOCK) {
+            int x1 = std::min(x0 + TRANSPOSE_BLOCK, width);
+            int xKernel = x0 + (x1 - x0) / KERNEL_SIZE * KERNEL_SIZE;
+
+            for(int y = y0; y < yKernel; y += KERNEL_SIZE) {
+                for(int x = x0; x < xKernel; x += KERNEL_SIZE) {
+                    transposeKernel(src + y * width + x, width, dst + x * height + y, height);
+                }
+                for(int x = xKernel; x < x1; ++x) {
+                    for(int k = y; k < y + KERNEL_SIZE; ++k) {
+                        dst[x * height + k] = src[k * width + x];
+                    }
+                }
+            }
+            for(int y = yKernel; y < y1; ++y) {
+                for(int x = x0; x < x1; ++x) {
+                    dst[x * height + y] = src[y * width + x];
+                }
+            }
+        }
+    }
+}
+
+void transposeTile(const void *src, void *dst, int width, int height, int elementSize) {
+    switch(elementSize) {
+        case 4:
+            transposeBlocked(static_cast<const std::uint32_t*>(src), static_cast<std::uint32_t*>(dst), width, height);
+            break;
+        case 2:
+            transposeBlocked(static_cast<const std::uint16_t*>(src), static_cast<std::uint16_t*>(dst), width, height);
+            break;
+        default:
+            transposeBlocked(static_cast<const std::uint8_t*>(src), static_cast<std::uint8_t*>(dst), width, height);
+            break;
+    }
+}
+
+#if TILE_TRANSFORM_WIDTH > 1
+/**
+ * Reverses the order of the elements in a register
+ */
+static __m128i reverseLanes(__m128i v, std::uint32_t) {
+    return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static __m128i reverseLanes(__m128i v, std::uint16_t) {
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+static __m128i reverseLanes(__m128i v, std::uint8_t) {
+    // Swapping the bytes of every 16-bit word leaves a word reversal
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    return reverseLanes(v, std::uint16_t());
+}
+#endif
+
+/**
+ * Reverses every row of a buffer, a register from each end at a time until they meet
+ */
+template<typename T>
+static void reverseRows(T *buffer, int width, int height) {
+    for(int y = 0; y < height; ++y) {
+        T *row = buffer + y * width;
+        int left = 0, right = width;
+#if TILE_TRANSFORM_WIDTH > 1
+        constexpr int lanes = 16 / sizeof(T);
+        for(; right - left >= 2 * lanes; left += lanes, right -= lanes) {
+            __m128i *l = reinterpret_cast<__m128i*>(row + left);
+            __m128i *r = reinterpret_cast<__m128i*>(row + right - lanes);
+            __m128i a = _mm_loadu_si128(l), b = _mm_loadu_si128(r);
+            _mm_storeu_si128(l, reverseLanes(b, T()));
+            _mm_storeu_si128(r, reverseLanes(a, T()));
+        }
+#endif
+        std::reverse(row + left, row + right);
+    }
+}
+
+void flipTileX(void *buffer, int width, int height, int elementSize) {
+    switch(elementSize) {
+        case 4:
+            reverseRows(static_cast<std::uint32_t*>(buffer), width, height);
+            break;
+        case 2:
+            reverseRows(static_cast<std::uint16_t*>(buffer), width, height);
+            break;
+        default:
+            reverseRows(static_cast<std::uint8_t*>(buffer), width, height);
+            break;
+    }
+}
+
+void flipTileY(void *buffer, int width, int height, int elementSize) {
+    // Rows are contiguous, so whole rows are swapped with block copies
+    std::size_t rowBytes = std::size_t(width) * elementSize;
+    std::vector<unsigned char> temp(rowBytes);
+    unsigned char *bytes = static_cast<unsigned char*>(buffer);
+    for(int y = 0; y < height / 2; ++y) {
+        unsigned char *top = bytes + y * rowBytes;
+        unsigned char *bottom = bytes + (height - 1 - y) * rowBytes;
+        std::memcpy(temp.data(), top, rowBytes);
+        std::memcpy(top, bottom, rowBytes);
+        std::memcpy(bottom, temp.data(), rowBytes);
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ * @file TileTransform.h
+ * 
+ * TileTransform header file
+ */
+#pragma once
+
+
+/**
+ * Transposes a row by row buffer of any width and height into another buffer
+ * 
+ * The buffer is walked in 64x64 blocks that stay in cache, each moved as 8x8 blocks
+ * transposed in registers with AVX2 or SSE2 when compiled for them, so the transpose runs
+ * at memory bandwidth instead of stalling on column-strided accesses.
+ * 
+ * @param src the width x height buffer to read
+ * @param dst out: the height x width buffer to write, must not overlap src
+ * @param width the width of src
+ * @param height the height of src
+ * @param elementSize bytes per element: 1, 2 or 4
+ */
+void transposeTile(const void *src, void *dst, int width, int height, int elementSize);
+
+
+/**
+ * Reverses every row of a row by row buffer in place, a flip around the Y axis
+ * 
+ * Rows are reversed a register at a time from both ends with SSE2 when compiled for it.
+ * 
+ * @param buffer the width x height buffer
+ * @param width the width of the buffer
+ * @param height the height of the buffer
+ * @param elementSize bytes per element: 1, 2 or 4
+ */
+void flipTileX(void *buffer, int width, int height, int elementSize);
+
+
+/**
+ * Reverses the row order of a row by row buffer in place, a flip around the X axis
+ * 
+ * @param buffer the width x height buffer
+ * @param width the width of the buffer
+ * @param height the height of the buffer
+ * @param elementSize bytes per element: 1, 2 or 4
+ */
+void flipTileY(void *buffer, int width, int height, int elementSize);
@@ -5,6 +5,7 @@
  */
 #include "WalkingGradient.h"
 
+#include <algorithm>
 #include <chrono>
 #include <glm/vec2.hpp>
 #include <glm/gtx/closest_point.hpp>
@@ -12,16 +13,40 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <numeric>
 #include <cmath>
-#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "stb_image_write.h"
 
+#include "DistanceTransform.h"
+#include "JumpFlood.h"
+#include "Parallel.h"
+#include "Philox.h"
+#include "SeamFunction.h"
+#include "SeamBank.h"
+#include "SeamKernel.h"
+#include "SeamPath.h"
+#include "SeamSide.h"
+#include "SegmentGrid.h"
+#include "SplineSeam.h"
+#include "TileTransform.h"
+
+/**
+ * Signed distance stored for pixels known to be farther from the seam than steepness
+ */
+static constexpr float FAR_DISTANCE = std::numeric_limits<float>::infinity();
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 #ifndef M_PI_2
-#define M_PI_2 3.14159265358979323846 / 2.0
+#define M_PI_2 (3.14159265358979323846 / 2.0)
 #endif
 #ifndef M_PI_4
-#define M_PI_4 3.14159265358979323846 / 4.0
+#define M_PI_4 (3.14159265358979323846 / 4.0)
 #endif
 
 
@@ -37,62 +62,291 @@ static glm::vec2 polar(const glm::vec2& u) {
 
 
 /**
- * Converts a polar coordinate to a euclidean/cartesian coordinate
+ * Converts evenly spaced polar corner samples to euclidean coordinates
+ * 
+ * The unit directions are built by rotating with a fixed step in double precision,
+ * so the conversion itself is a plain multiply loop the compiler can vectorize.
  * 
- * @param u a polar coordinate
- * @return euclidean/cartesian coordinate
+ * @param samples polar samples with angles (i - reach) * (PI / 2) / (sampleCount - 2 * reach - 1)
+ * @param eSamples out: euclidean samples
+ * @param sampleCount amount of seam samples
+ * @param reach samples before the one at angle 0, and after the one at PI / 2
  */
-static glm::vec2 euclidean(const glm::vec2& u) {
-    return {u.x * std::cos(u.y), u.x * std::sin(u.y)};
+static void euclidean(const glm::vec2 *samples, glm::vec2 *eSamples, int sampleCount, int reach) {
+    float *cosines = new float[sampleCount], *sines = new float[sampleCount];
+    double step = M_PI_2 / (sampleCount - 2 * reach - 1.0);
+    double stepCos = std::cos(step), stepSin = std::sin(step), c = std::cos(reach * step), s = -std::sin(reach * step);
+    for(int i = 0; i < sampleCount; ++i) {
+        cosines[i] = (float)c;
+        sines[i] = (float)s;
+        double next = c * stepCos - s * stepSin;
+        s = s * stepCos + c * stepSin;
+        c = next;
+    }
+    cosines[reach] = 1.0f;
+    sines[reach] = 0.0f;
+    cosines[sampleCount - 1 - reach] = 0.0f;
+    sines[sampleCount - 1 - reach] = 1.0f;
+
+    for(int i = 0; i < sampleCount; ++i) {
+        eSamples[i] = {samples[i].x * cosines[i], samples[i].x * sines[i]};
+    }
+
+    delete[] sines;
+    delete[] cosines;
 }
 
-static glm::vec2* generateEdgeSamples(const WGSettings& wgs) {
-    glm::vec2 *samples = new glm::vec2[wgs.sampleCount];
+/**
+ * Straightens the ends of a corner seam that continues into its neighbours
+ * 
+ * Edge seams cross tile borders as straight runs of evenly spaced samples. Corner samples
+ * within reach of a border are laid out the same way, so the seam continues exactly into an
+ * edge seam as well as into a corner seam. The arc in between only spans the angles between
+ * the runs, so it can not fold back across them, and its radius blends back from the runs'
+ * ends over the next reach samples.
+ * 
+ * @param samples polar samples
+ * @param eSamples out: euclidean samples
+ * @param sampleCount amount of seam samples
+ * @param reach samples before the one at angle 0, and after the one at PI / 2
+ * @param spacing distance between edge seam samples
+ */
+static void straightenCornerEnds(const glm::vec2 *samples, glm::vec2 *eSamples, int sampleCount, int reach, float spacing) {
+    int last = sampleCount - 1 - reach;
+    float fromAngle = 0.0f, toAngle = float(M_PI_2);
+    for(int j = -reach; j <= reach; ++j) {
+        // Along the top border at angle 0, the left border at PI / 2
+        eSamples[reach + j] = {samples[reach + j].x, j * spacing};
+        eSamples[last - j] = {j * spacing, samples[last - j].x};
+        fromAngle = std::max(fromAngle, std::atan2(eSamples[reach + j].y, eSamples[reach + j].x));
+        toAngle = std::min(toAngle, std::atan2(eSamples[last - j].y, eSamples[last - j].x));
+    }
 
-    unsigned seed;
-    std::default_random_engine generator;
-    std::normal_distribution<float> distribution(0.0f, 0.5f);
+    int first = 2 * reach, end = last - reach;
+    float fromExcess = glm::length(eSamples[first]) - samples[first].x;
+    float toExcess = glm::length(eSamples[end]) - samples[end].x;
+    for(int i = first + 1; i < end; ++i) {
+        float angle = fromAngle + (toAngle - fromAngle) * (i - first) / (end - first);
+        float radius = samples[i].x + fromExcess * std::max(0.0f, 1.0f - float(i - first) / reach)
+                                    + toExcess * std::max(0.0f, 1.0f - float(end - i) / reach);
+        eSamples[i] = radius * glm::vec2(std::cos(angle), std::sin(angle));
+    }
+}
 
-    float width_ratio = wgs.width / (float)(wgs.sampleCount - 1);
-    do {
-        seed = std::chrono::system_clock::now().time_since_epoch().count();
-        generator.seed(seed);
-        samples[0] = {0.0f, wgs.seamHeight};
-        for(int i = 1; i < wgs.sampleCount; ++i) {
-            float movement = distribution(generator) * wgs.variance;
-            samples[i] = {i * width_ratio, samples[i - 1].y + movement};
-        }
-    } while (std::abs(samples[0].y - samples[wgs.sampleCount - 1].y) > 1.0f);
+/**
+ * Generates seam offsets from seamHeight in closed form
+ * 
+ * The offsets start and end at 0, so no retries are needed.
+ * 
+ * @param offsets out: the seam offsets
+ * @param count amount of seam samples
+ * @param wgs walking gradient settings
+ */
+static void generateSeamFunction(float *offsets, int count, const WGSettings& wgs) {
+    Philox generator(wgs.seed, wgs.tile);
+    // Spread of the random walk over the whole seam, matching its steps of 0.5 * variance
+    float deviation = 0.5f * wgs.variance * std::sqrt(count - 1.0f);
+    if(wgs.seam == WGSeam::Fourier)
+        fourierSeam(offsets, count, wgs.seamDetail, deviation, generator);
+    else
+        noiseSeam(offsets, count, wgs.seamDetail, deviation, generator);
+}
 
-    return samples;
+/**
+ * Generates random walk offsets from seamHeight
+ * 
+ * The walk's drift is subtracted, a Brownian bridge, so it ends where it started and no
+ * retries are needed.
+ * 
+ * @param offsets out: the seam offsets
+ * @param count amount of seam samples
+ * @param wgs walking gradient settings
+ */
+static void generateWalkOffsets(float *offsets, int count, const WGSettings& wgs) {
+    Philox generator(wgs.seed, wgs.tile);
+
+    // All steps are drawn in one vectorized call, the walk is their prefix sum
+    offsets[0] = 0.0f;
+    generator.fillNormal(offsets + 1, count - 1);
+    for(int i = 1; i < count; ++i) {
+        offsets[i] = offsets[i - 1] + 0.5f * wgs.variance * offsets[i];
+    }
+
+    float drift = offsets[count - 1];
+    for(int i = 1; i < count; ++i) {
+        offsets[i] -= drift * i / (count - 1);
+    }
+}
+
+/**
+ * Gets the amount of samples a seam continues past each tile border into its neighbours
+ * 
+ * Corner seams straighten twice that many samples at each end, so a quarter of the seam at most.
+ * 
+ * @param wgs walking gradient settings
+ * @return half the length of seamStart and seamEnd, 0 if the seam shares no ends or they are too long
+ */
+static int sharedSeamReach(const WGSettings& wgs) {
+    int reach = (int(wgs.seamStart.size()) - 1) / 2;
+    if(reach <= 0 || wgs.seamEnd.size() != wgs.seamStart.size() || 4 * reach > WalkingGradient::getSeamSampleCount(wgs) - 1)
+        return 0;
+    return reach;
 }
 
-static glm::vec2* generateCornerSamples(const WGSettings& wgs) {
-    int sampleCount = M_PI_4 * wgs.sampleCount; // Quarter circle ratio
+/**
+ * Fills a seam's offsets from seamHeight, from the authored seam path or seam bank if one is given
+ * 
+ * With shared ends, the reach samples on either side of both tile borders are taken from
+ * seamStart and seamEnd, and the samples in between are re-pinned as a bridge from one to
+ * the other so the seam stays continuous.
+ * 
+ * @param offsets out: getSeamSampleCount(wgs) + 2 * reach seam offsets, the first reach lie before the tile
+ * @param wgs walking gradient settings
+ * @param reach sharedSeamReach(wgs)
+ */
+static void sampleSeamOffsets(float *offsets, const WGSettings& wgs, int reach) {
+    int count = WalkingGradient::getSeamSampleCount(wgs);
+    float *own = offsets + reach;
+    if(!wgs.seamPath.empty()) {
+        if(wgs.isCorner)
+            resampleCornerPath(wgs.seamPath, own, count, wgs.seamHeight);
+        else
+            resampleEdgePath(wgs.seamPath, own, count, wgs.width, wgs.seamHeight);
+    } else if(wgs.seamBank == nullptr) {
+        WalkingGradient::generateSeamOffsets(wgs, own);
+    } else {
+        // The tile's stream picks the banked seam, so a seed still reproduces the run
+        Philox generator(wgs.seed, wgs.tile);
+        const float *banked = wgs.seamBank->getOffsets(generator(), wgs.isCorner);
+        std::copy(banked, banked + count, own);
+    }
+    if(reach == 0)
+        return;
+
+    int a = reach, b = count - 1 - reach;
+    float fromOffset = own[a], toOffset = own[b];
+    float fromPin = wgs.seamStart.back(), toPin = wgs.seamEnd.front();
+    for(int i = a; i <= b; ++i) {
+        float t = float(i - a) / (b - a);
+        own[i] += (fromPin - fromOffset) + ((toPin - fromPin) - (toOffset - fromOffset)) * t;
+    }
+    std::copy(wgs.seamStart.begin(), wgs.seamStart.end(), offsets);
+    std::copy(wgs.seamEnd.begin(), wgs.seamEnd.end(), own + b);
+}
+
+static glm::vec2* generateEdgeSamples(const WGSettings& wgs, int& sampleCount) {
+    int reach = sharedSeamReach(wgs);
+    sampleCount = wgs.sampleCount + 2 * reach;
     glm::vec2 *samples = new glm::vec2[sampleCount];
+    float *offsets = new float[sampleCount];
+    sampleSeamOffsets(offsets, wgs, reach);
 
-    unsigned seed;
-    std::default_random_engine generator;
-    std::normal_distribution<float> distribution(0.0f, 0.5f);
+    float width_ratio = wgs.width / (float)(wgs.sampleCount - 1);
+    for(int i = 0; i < sampleCount; ++i) {
+        samples[i] = {(i - reach) * width_ratio, wgs.seamHeight + offsets[i]};
+    }
+    delete[] offsets;
+    return samples;
+}
 
-    float width_ratio = M_PI_2 / (sampleCount - 1.0);
-    do {
-        seed = std::chrono::system_clock::now().time_since_epoch().count();
-        generator.seed(seed);
-        samples[0] = {wgs.seamHeight, 0.0f};
-        for(int i = 1; i < sampleCount; ++i) {
-            float movement = distribution(generator) * wgs.variance;
-            samples[i] = {samples[i - 1].x + movement, i * width_ratio};
-        }
-    } while (std::abs(samples[0].x - samples[sampleCount - 1].x) > 1.0f);
+static glm::vec2* generateCornerSamples(const WGSettings& wgs, int& sampleCount) {
+    int reach = sharedSeamReach(wgs);
+    int tileSampleCount = WalkingGradient::getSeamSampleCount(wgs);
+    sampleCount = tileSampleCount + 2 * reach;
+    glm::vec2 *samples = new glm::vec2[sampleCount];
+    float *offsets = new float[sampleCount];
+    sampleSeamOffsets(offsets, wgs, reach);
 
+    // Samples past the borders continue the arc, its angles leave [0, pi / 2]
+    float width_ratio = M_PI_2 / (tileSampleCount - 1.0);
+    for(int i = 0; i < sampleCount; ++i) {
+        samples[i] = {wgs.seamHeight + offsets[i], (i - reach) * width_ratio};
+    }
+    delete[] offsets;
     return samples;
 }
 
-static float generateEdgeGradientPixel(glm::vec2* samples, int x, int y, const WGSettings& wgs) {
+/**
+ * Signs the seam distance of an edge pixel by its closest seam point
+ * 
+ * @param v the pixel position
+ * @param dw distance from the pixel to the seam
+ * @param closestPoint the closest point on the seam
+ * @return dw if the pixel is above the seam, -dw otherwise
+ */
+static float edgeSignedDistance(const glm::vec2& v, float dw, const glm::vec2& closestPoint) {
+    if(closestPoint.y < v.y)
+        return dw;
+    else
+        return -dw;
+}
+
+
+/**
+ * Gets the unit normal of a corner seam segment, pointing away from the origin
+ * 
+ * @param samples euclidean seam samples
+ * @param segment index of the segment, which ends at samples[segment]
+ * @return the normal, zero for a segment of zero length
+ */
+static glm::vec2 cornerSegmentNormal(const glm::vec2 *samples, int segment) {
+    glm::vec2 d = samples[segment] - samples[segment - 1];
+    float length = glm::length(d);
+    return length > 0.0f ? glm::vec2(d.y, -d.x) / length : glm::vec2(0.0f, 0.0f);
+}
+
+/**
+ * Signs the seam distance of a corner pixel by the side of its closest segment it lies on
+ * 
+ * Comparing the radii of the pixel and its closest point misjudges pixels whose closest point
+ * lies at another angle, wherever the seam runs towards or away from the origin, such as the
+ * straight runs crossing tile borders. The side of the closest segment is exact for any seam
+ * that does not cross itself. A pixel closest to a sample lies on the side of the sum of both
+ * segments' normals there, whichever of the two segments was found.
+ * 
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param v the pixel position
+ * @param dw distance from the pixel to the seam
+ * @param segment index of the closest segment, which ends at samples[segment]
+ * @return dw if the pixel is outside the seam, -dw otherwise
+ */
+static float cornerSignedDistance(const glm::vec2 *samples, int sampleCount, const glm::vec2& v, float dw, int segment) {
+    glm::vec2 a = samples[segment - 1], d = samples[segment] - a;
+    float t = glm::dot(v - a, d);
+    glm::vec2 normal = cornerSegmentNormal(samples, segment), point = a;
+    if(t <= 0.0f && segment > 1) {
+        normal += cornerSegmentNormal(samples, segment - 1);
+    } else if(t >= glm::dot(d, d) && segment < sampleCount - 1) {
+        normal += cornerSegmentNormal(samples, segment + 1);
+        point = samples[segment];
+    }
+    if(glm::dot(normal, v - point) > 0.0f)
+        return dw;
+    else
+        return -dw;
+}
+
+/**
+ * Signs the seam distance of a corner pixel by the side of a smooth seam it lies on
+ * 
+ * @param v the pixel position
+ * @param dw distance from the pixel to the seam
+ * @param closestPoint the closest point on the seam
+ * @param tangent the seam's direction of growing angle at the closest point
+ * @return dw if the pixel is outside the seam, -dw otherwise
+ */
+static float cornerSignedDistance(const glm::vec2& v, float dw, const glm::vec2& closestPoint, const glm::vec2& tangent) {
+    if(tangent.y * (v.x - closestPoint.x) - tangent.x * (v.y - closestPoint.y) > 0.0f)
+        return dw;
+    else
+        return -dw;
+}
+
+static float generateEdgeDistancePixel(const glm::vec2 *samples, int sampleCount, int x, int y, const WGSettings& wgs) {
     float dw = wgs.width * wgs.height;
     glm::vec2 v = { x, y }, currentPoint, closestPoint = {0.f, 0.f};
-    for(int i = 1; i < wgs.sampleCount; ++i) {
+    for(int i = 1; i < sampleCount; ++i) {
         currentPoint = glm::closestPointOnLine(v, samples[i], samples[i - 1]);
         float d = glm::distance(v, currentPoint);
         if(d < dw) {
@@ -100,133 +354,1136 @@ static float generateEdgeGradientPixel(glm::vec2* samples, int x, int y, const W
             closestPoint = currentPoint;
         }
     }
-    if(closestPoint.y < y)
-        return std::min(1.0f, 0.5f + dw / (2.0f * wgs.steepness));
-    else
-        return 0.5f - std::min(0.5f, dw / (2.0f * wgs.steepness));
+    return edgeSignedDistance(v, dw, closestPoint);
 }
 
-static float generateCornerGradientPixel(glm::vec2* samples, int x, int y, const WGSettings& wgs) {
-    int sampleCount = M_PI_4 * wgs.sampleCount; // Quarter circle ratio
+static float generateCornerDistancePixel(const glm::vec2 *samples, int sampleCount, int x, int y, const WGSettings& wgs) {
     float dw = wgs.width * wgs.height;
-    glm::vec2 v = {x, y}, currentPoint, closestPoint;
+    glm::vec2 v = {x, y};
+    int closestSegment = 1;
     for(int i = 1; i < sampleCount; ++i) {
-        currentPoint = glm::closestPointOnLine(v, samples[i - 1], samples[i]);
-        float d = glm::distance(v, currentPoint);
+        float d = glm::distance(v, glm::closestPointOnLine(v, samples[i - 1], samples[i]));
         if(d < dw) {
+            dw = d;
+            closestSegment = i;
+        }
+    }
+    return cornerSignedDistance(samples, sampleCount, v, dw, closestSegment);
+}
+
+/**
+ * Most segments the windowed backend searches for a pixel before it queries the segment grid
+ */
+static constexpr int WINDOW_LIMIT = 32;
+
+/**
+ * Finds the closest point on an edge seam by searching a window of segments around a hint
+ * 
+ * Edge sample x coordinates are strictly increasing, so a segment whose x range is
+ * farther than the best distance from the pixel can not win. The hint segment gives
+ * the first bound and the window is located with a binary search. Results match
+ * generateEdgeDistancePixel exactly.
+ * 
+ * The window spans twice the hint's distance, which grows with the pixel's distance from
+ * the seam and where the seam is steep. Windows of more than maxWindow segments are not
+ * searched, so the search costs at most maxWindow segments per pixel.
+ * 
+ * @param samples euclidean edge seam samples
+ * @param sampleCount amount of seam samples
+ * @param v the pixel position
+ * @param hint a segment likely to be close, such as the previous pixel's closest segment
+ * @param maxWindow most segments searched
+ * @param dw out: distance to the closest point
+ * @param closestPoint out: the closest point
+ * @return index of the closest segment, -1 if the window holds more than maxWindow segments
+ */
+static int windowedEdgeClosest(const glm::vec2 *samples, int sampleCount, const glm::vec2& v, int hint, int maxWindow, float& dw, glm::vec2& closestPoint) {
+    closestPoint = glm::closestPointOnLine(v, samples[hint], samples[hint - 1]);
+    dw = glm::distance(v, closestPoint);
+    int best = hint;
+
+    // First segment whose right end reaches x - dw, and the first one starting past x + dw
+    auto firstSegment = [&](int sample, float x) {
+        int lo = 1, hi = sampleCount;
+        while(lo < hi) {
+            int mid = (lo + hi) / 2;
+            if(samples[mid + sample].x < x)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    };
+    int lo = firstSegment(0, v.x - dw);
+    if(firstSegment(-1, std::nextafter(v.x + dw, std::numeric_limits<float>::infinity())) - lo > maxWindow)
+        return -1;
+
+    for(int i = lo; i < sampleCount && samples[i - 1].x <= v.x + dw; ++i) {
+        glm::vec2 currentPoint = glm::closestPointOnLine(v, samples[i], samples[i - 1]);
+        float d = glm::distance(v, currentPoint);
+        if(d < dw || (d == dw && i < best)) {
             dw = d;
             closestPoint = currentPoint;
+            best = i;
         }
     }
-    glm::vec2 polarClosestPoint = polar(closestPoint);
-    glm::vec2 polarPixelPoint = polar(v);
-    if(polarClosestPoint.x < polarPixelPoint.x)
-        return std::min(1.0f, 0.5f + dw / (2.0f * wgs.steepness));
-    else
-        return 0.5f - std::min(0.5f, dw / (2.0f * wgs.steepness));
+    return best;
 }
 
-static void generateEdgeGradient(float *data, const WGSettings& wgs) {
-    glm::vec2 *samples = generateEdgeSamples(wgs);
+/**
+ * Maps a signed seam distance to a gradient value
+ * 
+ * @param signedDistance distance to the seam, positive above (edge) or outside (corner) of it
+ * @param steepness the reach of the gradient's blending in pixels
+ * @return gradient value between 0.0 and 1.0
+ */
+static float falloff(float signedDistance, float steepness) {
+    return std::clamp(0.5f + signedDistance / (2.0f * steepness), 0.0f, 1.0f);
+}
 
-    for(int y = 0; y < wgs.height; ++y) {
+
+/**
+ * Rasterizes the seam polyline at half pixel steps onto a padded grid
+ * 
+ * The grid is padded so seam segments just outside the tile still influence it.
+ * 
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param pad padding on each side of the tile in pixels
+ * @param gw width of the padded grid
+ * @param gh height of the padded grid
+ * @param owner out: index of the segment that seeded each cell, -1 for cells off the seam
+ */
+static void rasterizeSeam(const glm::vec2 *samples, int sampleCount, int pad, int gw, int gh, int *owner) {
+    std::fill(owner, owner + gw * gh, -1);
+    for(int i = 1; i < sampleCount; ++i) {
+        glm::vec2 a = samples[i - 1], b = samples[i];
+        int steps = (int)std::ceil(2.0f * glm::distance(a, b)) + 1;
+        for(int s = 0; s <= steps; ++s) {
+            glm::vec2 p = a + (b - a) * (s / (float)steps);
+            int gx = (int)std::lround(p.x) + pad;
+            int gy = (int)std::lround(p.y) + pad;
+            if(gx < 0 || gy < 0 || gx >= gw || gy >= gh)
+                continue;
+            owner[gy * gw + gx] = i;
+        }
+    }
+}
+
+
+/**
+ * Writes signed distance rows from a nearby seed cell map of the rasterized seam
+ * 
+ * A seed cell lies within half a pixel diagonal of the seam, so the distance to a pixel's seed
+ * cell plus one pixel bounds its distance to the seam. The segment grid then only visits
+ * segments within that bound, which gives exactly the brute force reference's distance and
+ * sign, for any seed cell and not only the nearest one. With narrow band enabled, pixels the
+ * far test proves farther than steepness are filled with FAR_DISTANCE on the side SeamSide
+ * finds, and only measured if it leaves them undecided.
+ * 
+ * @param out function storing signed distance d of pixel index i when called as out(i, d)
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ * @param grid segment grid over the seam samples
+ * @param seamSide seam ranges deciding the side of skipped pixels
+ * @param feature a nearby seed cell of every padded grid cell, -1 if unknown
+ * @param pad padding on each side of the tile in pixels
+ * @param y0 first row to write
+ * @param y1 one past the last row to write
+ * @param far function returning true if pixel (x, y) with seed cell distance d, -1 if unknown,
+ *            is farther than steepness from the seam
+ */
+template<typename DistanceOutput, typename FarTest>
+static void resolveSeedDistance(DistanceOutput out, const glm::vec2 *samples, int sampleCount, const WGSettings& wgs,
+                                const SegmentGrid& grid, const SeamSide& seamSide, const int *feature, int pad, int y0, int y1, FarTest far) {
+    int gw = wgs.width + 2 * pad;
+    for(int y = y0; y < y1; ++y) {
         int yOffset = y * wgs.width;
         for(int x = 0; x < wgs.width; ++x) {
-            data[yOffset + x] = generateEdgeGradientPixel(samples, x, y, wgs);
+            glm::vec2 v = {x, y}, closestPoint = {0.f, 0.f};
+            float seedDistance = -1.0f;
+            int f = feature[(y + pad) * gw + x + pad];
+            if(f >= 0) {
+                float fx = (float)(f % gw - pad - x), fy = (float)(f / gw - pad - y);
+                seedDistance = std::sqrt(fx * fx + fy * fy);
+            }
+            if(wgs.narrowBand && far(x, y, seedDistance)) {
+                int side = seamSide.side(v);
+                if(side != 0) {
+                    out(yOffset + x, side > 0 ? FAR_DISTANCE : -FAR_DISTANCE);
+                    continue;
+                }
+            }
+
+            float dw = seedDistance >= 0.0f ? seedDistance + 1.0f : wgs.width * wgs.height;
+            int segment = grid.closest(v, dw, closestPoint);
+            if(segment < 0) {
+                // Nothing strictly inside the bound, the closest segment lies exactly on it
+                dw = wgs.width * wgs.height;
+                segment = grid.closest(v, dw, closestPoint);
+            }
+            float signedDistance = wgs.isCorner ? cornerSignedDistance(samples, sampleCount, v, dw, segment)
+                                                : edgeSignedDistance(v, dw, closestPoint);
+            if(wgs.narrowBand && dw > wgs.steepness)
+                signedDistance = signedDistance > 0.0f ? FAR_DISTANCE : -FAR_DISTANCE;
+            out(yOffset + x, signedDistance);
         }
     }
+}
 
-    delete samples;
+
+/**
+ * Generates a signed distance field using a euclidean distance transform of the rasterized seam
+ * 
+ * The transform finds every pixel's nearest seed cell. The seam is rasterized at under half
+ * pixel steps, so the nearest seed cell is less than a pixel farther than the seam, and with
+ * narrow band enabled pixels whose seed cell is farther than steepness plus a pixel are
+ * skipped. The others are refined exactly, so the result matches the brute force reference.
+ * The transform is linear in the padded tile area, the refinement is not.
+ * 
+ * @param out function storing signed distance d of pixel index i when called as out(i, d)
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ */
+template<typename DistanceOutput>
+static void generateTransformDistance(DistanceOutput out, const glm::vec2 *samples, int sampleCount, const WGSettings& wgs) {
+    int pad = (int)std::ceil(wgs.steepness) + 2;
+    int gw = wgs.width + 2 * pad, gh = wgs.height + 2 * pad;
+    // The seam's cells seed the transform in place, so the tile needs one int per padded pixel
+    int *feature = new int[gw * gh];
+    rasterizeSeam(samples, sampleCount, pad, gw, gh, feature);
+    distanceTransform(feature, gw, gh);
+    // Edge pixels scan segments from samples[i] to samples[i - 1]
+    SegmentGrid segments(samples, sampleCount, !wgs.isCorner, wgs.isCorner);
+    SeamSide seamSide(samples, sampleCount, wgs.isCorner, 0.0f);
+    resolveSeedDistance(out, samples, sampleCount, wgs, segments, seamSide, feature, pad, 0, wgs.height, [&](int, int, float seedDistance) {
+        return seedDistance > wgs.steepness + 1.0f;
+    });
+
+    delete[] feature;
 }
 
-static void generateCornerGradient(float *data, const WGSettings& wgs) {
-    int sampleCount = M_PI_4 * wgs.sampleCount; // Quarter circle ratio
-    glm::vec2 *samples = generateCornerSamples(wgs);
-    glm::vec2 *eSamples = new glm::vec2[sampleCount];
 
-    for(int i = 0; i < sampleCount; ++i) {
-        eSamples[i] = euclidean(samples[i]);
+/**
+ * Computes the band of rows each edge column needs distance queries for
+ * 
+ * Pixels below lo[x] or above hi[x] are farther than steepness from the seam.
+ * 
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ * @param lo out: lowest y within the band, one per column
+ * @param hi out: highest y within the band, one per column
+ */
+static void computeEdgeBand(const glm::vec2 *samples, int sampleCount, const WGSettings& wgs, float *lo, float *hi) {
+    float s = wgs.steepness;
+    std::fill(lo, lo + wgs.width, std::numeric_limits<float>::max());
+    std::fill(hi, hi + wgs.width, std::numeric_limits<float>::lowest());
+    for(int i = 1; i < sampleCount; ++i) {
+        glm::vec2 a = samples[i - 1], b = samples[i];
+        int x0 = std::max(0, (int)std::ceil(std::min(a.x, b.x) - s));
+        int x1 = std::min(wgs.width - 1, (int)std::floor(std::max(a.x, b.x) + s));
+        for(int x = x0; x <= x1; ++x) {
+            lo[x] = std::min(lo[x], std::min(a.y, b.y) - s);
+            hi[x] = std::max(hi[x], std::max(a.y, b.y) + s);
+        }
     }
+}
 
-    delete[] samples;
-    samples = nullptr;
 
+/**
+ * Maps a corner pixel to its angular sector without trigonometry
+ * 
+ * Sectors are uniform in y / (x + y), which grows monotonically with the angle.
+ * 
+ * @param v the pixel position, in the first quadrant
+ * @param sectors amount of sectors
+ * @return sector index
+ */
+static int cornerSector(const glm::vec2& v, int sectors) {
+    if(v.x + v.y <= 0.0f)
+        return 0;
+    return std::min(sectors - 1, (int)(sectors * v.y / (v.x + v.y)));
+}
+
+
+/**
+ * Computes the band of squared radii each corner sector needs distance queries for
+ * 
+ * A seam point p is at least |p| - |v| and |p| * sin(angle between them) away from a pixel v,
+ * so only seam segments within asin(steepness / minimum seam radius) of a sector can reach it.
+ * 
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ * @param loSq out: lowest squared radius within the band, one per sector
+ * @param hiSq out: highest squared radius within the band, one per sector
+ * @param sectors amount of sectors
+ */
+static void computeCornerBand(const glm::vec2 *samples, int sampleCount, const WGSettings& wgs, float *loSq, float *hiSq, int sectors) {
+    float s = wgs.steepness;
+    int segments = sampleCount - 1;
+    float *rMin = new float[segments], *rMax = new float[segments];
+    float *angleMin = new float[segments], *angleMax = new float[segments];
+    float minRadius = std::numeric_limits<float>::max();
+    for(int i = 1; i < sampleCount; ++i) {
+        glm::vec2 a = polar(samples[i - 1]), b = polar(samples[i]);
+        float span = std::abs(b.y - a.y);
+        // The chord dips towards the origin by at most cos(span / 2)
+        rMin[i - 1] = span < float(M_PI) ? std::min(a.x, b.x) * std::cos(span / 2.0f) : 0.0f;
+        rMax[i - 1] = std::max(a.x, b.x);
+        angleMin[i - 1] = std::min(a.y, b.y);
+        angleMax[i - 1] = std::max(a.y, b.y);
+        minRadius = std::min(minRadius, rMin[i - 1]);
+    }
+
+    float lo = std::numeric_limits<float>::max(), hi = 0.0f;
+    std::fill(loSq, loSq + sectors, lo);
+    std::fill(hiSq, hiSq + sectors, hi);
+    float reach = minRadius > s ? std::asin(s / minRadius) : float(M_PI_2);
+    for(int i = 0; i < segments; ++i) {
+        float a0 = std::max(0.0f, angleMin[i] - reach);
+        float a1 = std::min(float(M_PI_2), angleMax[i] + reach);
+        int k0 = cornerSector({std::cos(a0), std::sin(a0)}, sectors);
+        int k1 = cornerSector({std::cos(a1), std::sin(a1)}, sectors);
+        if(reach >= M_PI_2 || a0 > a1) {
+            k0 = 0;
+            k1 = sectors - 1;
+        }
+        for(int k = k0; k <= k1; ++k) {
+            loSq[k] = std::min(loSq[k], rMin[i] - s);
+            hiSq[k] = std::max(hiSq[k], rMax[i] + s);
+        }
+    }
+    for(int k = 0; k < sectors; ++k) {
+        loSq[k] = loSq[k] > 0.0f ? loSq[k] * loSq[k] : -1.0f;
+        hiSq[k] = hiSq[k] * hiSq[k];
+    }
+
+    delete[] angleMax;
+    delete[] angleMin;
+    delete[] rMax;
+    delete[] rMin;
+}
+
+
+/**
+ * Generates a signed distance field by jump flooding the rasterized seam
+ * 
+ * Jump flooding may miss a pixel's nearest seed cell, but any seed cell it finds still bounds
+ * the pixel's distance, which is then refined exactly, so the result matches the brute force
+ * reference. A missed nearest seed proves nothing about a pixel being far, so with narrow band
+ * enabled pixels are skipped by the same column (edge) or sector (corner) band as the pixel
+ * backends, and seeds only need to flood across that band, which takes a few passes instead of
+ * log2 of the tile size. Flooding passes and the final resolve are split into row ranges
+ * across threads.
+ * 
+ * @param out function storing signed distance d of pixel index i when called as out(i, d)
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ */
+template<typename DistanceOutput>
+static void generateJumpFloodDistance(DistanceOutput out, const glm::vec2 *samples, int sampleCount, const WGSettings& wgs) {
+    int pad = (int)std::ceil(wgs.steepness) + 2;
+    int gw = wgs.width + 2 * pad, gh = wgs.height + 2 * pad;
+    // Seam cells become their own seeds in place, so the tile needs one int per padded pixel
+    int *feature = new int[gw * gh];
+    rasterizeSeam(samples, sampleCount, pad, gw, gh, feature);
+    for(int i = 0; i < gw * gh; ++i) {
+        feature[i] = feature[i] < 0 ? -1 : i;
+    }
+
+    // Band pixels beyond the flood's reach keep no seed and are measured without a bound
+    jumpFlood(feature, gw, gh, wgs.threads, wgs.narrowBand ? 2 * pad : 0);
+    SegmentGrid segments(samples, sampleCount, !wgs.isCorner, wgs.isCorner);
+    SeamSide seamSide(samples, sampleCount, wgs.isCorner, 0.0f);
+
+    int sectors = std::max(1, sampleCount - 1);
+    std::vector<float> bandLo(wgs.isCorner ? sectors : wgs.width), bandHi(bandLo.size());
+    if(wgs.narrowBand && wgs.isCorner)
+        computeCornerBand(samples, sampleCount, wgs, bandLo.data(), bandHi.data(), sectors);
+    else if(wgs.narrowBand)
+        computeEdgeBand(samples, sampleCount, wgs, bandLo.data(), bandHi.data());
+    auto far = [&](int x, int y, float) {
+        if(!wgs.isCorner)
+            return y < bandLo[x] || y > bandHi[x];
+        int k = cornerSector({x, y}, sectors);
+        float rSq = float(x * x + y * y);
+        return rSq < bandLo[k] || rSq > bandHi[k];
+    };
+    parallelFor(wgs.height, wgs.threads, [&](int y0, int y1) {
+        resolveSeedDistance(out, samples, sampleCount, wgs, segments, seamSide, feature, pad, y0, y1, far);
+    });
+
+    delete[] feature;
+}
+
+
+/**
+ * Generates a signed distance field by evaluating a pixel function for every pixel
+ * 
+ * With narrow band enabled, pixels farther than steepness from the seam are known
+ * to saturate and are filled with FAR_DISTANCE. Their sign follows the same closest point
+ * rule as measured pixels, decided from the seam's height range near their column (edge) or
+ * radius range near their direction (corner). Only pixels that range leaves undecided, where
+ * the seam folds back around them, are measured.
+ * 
+ * @param out function storing signed distance d of pixel index i when called as out(i, d)
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ * @param pixel function returning the signed distance of pixel (x, y)
+ */
+template<typename DistanceOutput, typename PixelFunction>
+static void generatePixelDistance(DistanceOutput out, const glm::vec2 *samples, int sampleCount, const WGSettings& wgs, PixelFunction pixel) {
+    if(!wgs.narrowBand) {
+        for(int y = 0; y < wgs.height; ++y) {
+            int yOffset = y * wgs.width;
+            for(int x = 0; x < wgs.width; ++x) {
+                out(yOffset + x, pixel(x, y));
+            }
+        }
+        return;
+    }
+
+    // One pixel of slack covers seams measured off their polyline, such as splines
+    SeamSide seamSide(samples, sampleCount, wgs.isCorner, 1.0f);
+    auto saturate = [&](int x, int y) {
+        float side = (float)seamSide.side({x, y});
+        if(side == 0.0f)
+            side = pixel(x, y);
+        return side > 0.0f ? FAR_DISTANCE : -FAR_DISTANCE;
+    };
+
+    if(!wgs.isCorner) {
+        float *lo = new float[wgs.width], *hi = new float[wgs.width];
+        computeEdgeBand(samples, sampleCount, wgs, lo, hi);
+        for(int y = 0; y < wgs.height; ++y) {
+            int yOffset = y * wgs.width;
+            for(int x = 0; x < wgs.width; ++x) {
+                if(y < lo[x] || y > hi[x])
+                    out(yOffset + x, saturate(x, y));
+                else
+                    out(yOffset + x, pixel(x, y));
+            }
+        }
+        delete[] hi;
+        delete[] lo;
+        return;
+    }
+
+    int sectors = std::max(1, sampleCount - 1);
+    float *loSq = new float[sectors], *hiSq = new float[sectors];
+    computeCornerBand(samples, sampleCount, wgs, loSq, hiSq, sectors);
     for(int y = 0; y < wgs.height; ++y) {
         int yOffset = y * wgs.width;
         for(int x = 0; x < wgs.width; ++x) {
-            data[yOffset + x] = generateCornerGradientPixel(eSamples, x, y, wgs);
+            glm::vec2 v = {x, y};
+            int k = cornerSector(v, sectors);
+            float rSq = v.x * v.x + v.y * v.y;
+            if(rSq < loSq[k] || rSq > hiSq[k])
+                out(yOffset + x, saturate(x, y));
+            else
+                out(yOffset + x, pixel(x, y));
         }
     }
+    delete[] hiSq;
+    delete[] loSq;
+}
+
 
-    delete[] eSamples;
+/**
+ * Intersects the seam with a column (edge) or a ray from the origin (corner)
+ * 
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param v the point whose column (edge) or direction (corner) is intersected
+ * @param isCorner if the seam is a corner seam, otherwise edge seam
+ * @return the point on the seam
+ */
+static glm::vec2 seamCrossing(const glm::vec2 *samples, int sampleCount, const glm::vec2& v, bool isCorner) {
+    int lo = 1, hi = sampleCount - 1;
+    while(lo < hi) {
+        int mid = (lo + hi) / 2;
+        bool before = isCorner ? samples[mid].x * v.y - samples[mid].y * v.x > 0.0f : samples[mid].x < v.x;
+        if(before)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    glm::vec2 a = samples[lo - 1], d = samples[lo] - samples[lo - 1];
+    float t;
+    if(isCorner) {
+        float denominator = d.x * v.y - d.y * v.x;
+        t = denominator != 0.0f ? (a.y * v.x - a.x * v.y) / denominator : 0.0f;
+    } else {
+        t = d.x != 0.0f ? (v.x - a.x) / d.x : 0.0f;
+    }
+    return a + std::clamp(t, 0.0f, 1.0f) * d;
 }
 
-static void generateGradient(float *data, const WGSettings& wgs) {
-    if(wgs.isCorner)
-        generateCornerGradient(data, wgs);
-    else
-        generateEdgeGradient(data, wgs);
+
+/**
+ * Generates a signed distance field coarse to fine
+ * 
+ * The distance is first measured on a lattice of every coarseFactor-th pixel, the corners of
+ * the blocks, which neighbouring blocks share. Every pixel of a block lies within the block
+ * diagonal of each corner, so a block whose corners are all farther than steepness plus the
+ * diagonal from the seam holds only saturated pixels. Its pixels' closest seam points lie
+ * within the nearest corner's distance plus the diagonal, so if every segment that close lies
+ * below (edge) or inside (corner) the block, or every one above or outside it, all its pixels
+ * take that sign and the block is filled without further queries. Other blocks are refined
+ * at full resolution, which keeps the result identical to measuring every pixel.
+ * 
+ * @param out function storing signed distance d of pixel index i when called as out(i, d)
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ * @param pixel function returning the signed distance of pixel (x, y)
+ */
+template<typename DistanceOutput, typename PixelFunction>
+static void generateCoarseToFineDistance(DistanceOutput out, const glm::vec2 *samples, int sampleCount, const WGSettings& wgs, PixelFunction pixel) {
+    int block = wgs.coarseFactor;
+    int latticeX = (wgs.width + block - 1) / block + 1;
+    // Lattice column k is pixel column min(k * block, width - 1), rows likewise
+    auto latticeRow = [&](int k, std::vector<float>& row) {
+        int y = std::min(k * block, wgs.height - 1);
+        for(int j = 0; j < latticeX; ++j) {
+            row[j] = pixel(std::min(j * block, wgs.width - 1), y);
+        }
+    };
+    std::vector<float> top(latticeX), bottom(latticeX);
+    latticeRow(0, top);
+
+    // Height (edge) or radius (corner) range of every segment, which the sign is decided by
+    int segments = sampleCount - 1;
+    std::vector<float> positionLo(segments), positionHi(segments);
+    for(int i = 1; i < sampleCount; ++i) {
+        glm::vec2 a = samples[i - 1], b = samples[i];
+        if(wgs.isCorner) {
+            positionLo[i - 1] = glm::length(glm::closestPointOnLine(glm::vec2(0.0f, 0.0f), a, b));
+            positionHi[i - 1] = std::max(glm::length(a), glm::length(b));
+        } else {
+            positionLo[i - 1] = std::min(a.y, b.y);
+            positionHi[i - 1] = std::max(a.y, b.y);
+        }
+    }
+
+    for(int by = 0, ky = 0; by < wgs.height; by += block, ++ky) {
+        int y1 = std::min(wgs.height, by + block);
+        latticeRow(ky + 1, bottom);
+        for(int bx = 0, kx = 0; bx < wgs.width; bx += block, ++kx) {
+            int x1 = std::min(wgs.width, bx + block);
+            float corners[4] = {top[kx], top[kx + 1], bottom[kx], bottom[kx + 1]};
+            float diagonal = glm::length(glm::vec2(std::min(x1, wgs.width - 1) - bx, std::min(y1, wgs.height - 1) - by));
+            float nearest = std::min({std::abs(corners[0]), std::abs(corners[1]), std::abs(corners[2]), std::abs(corners[3])});
+
+            float fill = 0.0f;
+            if(nearest > wgs.steepness + diagonal) {
+                // One pixel of slack covers seams measured off their polyline, such as splines
+                float halo = nearest + diagonal + 1.0f;
+                float blockLo = wgs.isCorner ? glm::length(glm::vec2(bx, by)) : by;
+                float blockHi = wgs.isCorner ? glm::length(glm::vec2(x1 - 1, y1 - 1)) : y1 - 1;
+                bool below = true, above = true;
+                for(int i = 1; i < sampleCount && (below || above); ++i) {
+                    glm::vec2 a = samples[i - 1], b = samples[i];
+                    float gapX = std::max({std::min(a.x, b.x) - (x1 - 1), bx - std::max(a.x, b.x), 0.0f});
+                    float gapY = std::max({std::min(a.y, b.y) - (y1 - 1), by - std::max(a.y, b.y), 0.0f});
+                    if(gapX * gapX + gapY * gapY > halo * halo)
+                        continue;
+                    below = below && positionHi[i - 1] < blockLo;
+                    above = above && positionLo[i - 1] > blockHi;
+                }
+                fill = below ? FAR_DISTANCE : above ? -FAR_DISTANCE : 0.0f;
+            }
+            if(fill != 0.0f) {
+                for(int y = by; y < y1; ++y) {
+                    for(int x = bx; x < x1; ++x) {
+                        out(y * wgs.width + x, fill);
+                    }
+                }
+                continue;
+            }
+            for(int y = by; y < y1; ++y) {
+                for(int x = bx; x < x1; ++x) {
+                    out(y * wgs.width + x, pixel(x, y));
+                }
+            }
+        }
+        std::swap(top, bottom);
+    }
+}
+
+
+/**
+ * Side length of the square blocks measured by the blocked backend
+ * 
+ * A 64x64 block of distances is 16 KiB, so a block and its segments stay in L2.
+ */
+static constexpr int BLOCK_SIZE = 64;
+
+
+/**
+ * Side length of the sub-blocks each block narrows its segments down for
+ * 
+ * The halo of a block grows with its radius, far from the seam a 64x64 block keeps most of
+ * the seam. An 8x8 sub-block keeps about the seam within its own distance instead.
+ */
+static constexpr int SUB_BLOCK_SIZE = 8;
+
+
+/**
+ * Generates a signed distance field in independent square blocks
+ * 
+ * Each block measures its center pixel against every segment. Every pixel in the block is
+ * then at most the center distance plus the distance to the center from the seam, so only
+ * segments whose bounding box lies within that halo of the block can be closest. Sub-blocks
+ * narrow the block's segments down the same way, and their pixels are scanned against what
+ * is left in seam order, which matches the brute force reference exactly. With narrow band
+ * enabled, blocks and sub-blocks farther than steepness from the seam are filled without
+ * scanning. Blocks are split across wgs.threads threads.
+ * 
+ * @param out function storing signed distance d of pixel index i when called as out(i, d)
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ */
+template<typename DistanceOutput>
+static void generateBlockedDistance(DistanceOutput out, const glm::vec2 *samples, int sampleCount, const WGSettings& wgs) {
+    int blocksX = (wgs.width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    int blocksY = (wgs.height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    // Edge pixels scan segments from samples[i] to samples[i - 1], corner pixels the other way
+    auto segment = [&](int i, glm::vec2& a, glm::vec2& b) {
+        a = wgs.isCorner ? samples[i - 1] : samples[i];
+        b = wgs.isCorner ? samples[i] : samples[i - 1];
+    };
+    auto signedDistance = [&](const glm::vec2& v, float dw, const glm::vec2& closestPoint, int closestSegment) {
+        if(wgs.isCorner)
+            return cornerSignedDistance(samples, sampleCount, v, dw, closestSegment);
+        return edgeSignedDistance(v, dw, closestPoint);
+    };
+
+    // Measures the center of the block from x0, y0 to x1, y1 (exclusive) against segments and keeps
+    // those within its halo, returns false if narrow band filled the block instead
+    auto gatherSegments = [&](int x0, int y0, int x1, int y1, const std::vector<int>& segments, std::vector<int>& kept) {
+        glm::vec2 center = {(x0 + x1 - 1) / 2, (y0 + y1 - 1) / 2}, a, b;
+        float centerDistance = wgs.width * wgs.height;
+        glm::vec2 closestPoint = {0.f, 0.f};
+        int closestSegment = 1;
+        for(int i : segments) {
+            segment(i, a, b);
+            glm::vec2 currentPoint = glm::closestPointOnLine(center, a, b);
+            float d = glm::distance(center, currentPoint);
+            if(d < centerDistance) {
+                centerDistance = d;
+                closestPoint = currentPoint;
+                closestSegment = i;
+            }
+        }
+        float radius = glm::length(glm::vec2(std::max(center.x - x0, x1 - 1 - center.x), std::max(center.y - y0, y1 - 1 - center.y)));
+
+        if(wgs.narrowBand && centerDistance - radius > wgs.steepness) {
+            float fill = signedDistance(center, 1.0f, closestPoint, closestSegment) > 0.0f ? FAR_DISTANCE : -FAR_DISTANCE;
+            for(int y = y0; y < y1; ++y) {
+                for(int x = x0; x < x1; ++x) {
+                    out(y * wgs.width + x, fill);
+                }
+            }
+            return false;
+        }
+
+        // One pixel of slack keeps rounding from dropping a segment on the halo's edge
+        float halo = centerDistance + radius + 1.0f;
+        kept.clear();
+        for(int i : segments) {
+            segment(i, a, b);
+            float gapX = std::max({std::min(a.x, b.x) - (x1 - 1), x0 - std::max(a.x, b.x), 0.0f});
+            float gapY = std::max({std::min(a.y, b.y) - (y1 - 1), y0 - std::max(a.y, b.y), 0.0f});
+            if(gapX * gapX + gapY * gapY <= halo * halo)
+                kept.push_back(i);
+        }
+        return true;
+    };
+
+    std::vector<int> allSegments(sampleCount - 1);
+    std::iota(allSegments.begin(), allSegments.end(), 1);
+
+    parallelFor(blocksX * blocksY, wgs.threads, [&](int begin, int end) {
+        std::vector<int> blockSegments, candidateSegments;
+        std::vector<glm::vec2> candidates;
+        for(int block = begin; block < end; ++block) {
+            int bx = block % blocksX * BLOCK_SIZE, by = block / blocksX * BLOCK_SIZE;
+            int bx1 = std::min(wgs.width, bx + BLOCK_SIZE), by1 = std::min(wgs.height, by + BLOCK_SIZE);
+            if(!gatherSegments(bx, by, bx1, by1, allSegments, blockSegments))
+                continue;
+
+            for(int sy = by; sy < by1; sy += SUB_BLOCK_SIZE) {
+                for(int sx = bx; sx < bx1; sx += SUB_BLOCK_SIZE) {
+                    int x1 = std::min(bx1, sx + SUB_BLOCK_SIZE), y1 = std::min(by1, sy + SUB_BLOCK_SIZE);
+                    if(!gatherSegments(sx, sy, x1, y1, blockSegments, candidateSegments))
+                        continue;
+                    candidates.clear();
+                    for(int i : candidateSegments) {
+                        glm::vec2 a, b;
+                        segment(i, a, b);
+                        candidates.push_back(a);
+                        candidates.push_back(b);
+                    }
+
+                    for(int y = sy; y < y1; ++y) {
+                        for(int x = sx; x < x1; ++x) {
+                            float dw = wgs.width * wgs.height;
+                            glm::vec2 v = {x, y}, closestPoint = {0.f, 0.f};
+                            int closestSegment = 1;
+                            for(size_t i = 0; i < candidates.size(); i += 2) {
+                                glm::vec2 currentPoint = glm::closestPointOnLine(v, candidates[i], candidates[i + 1]);
+                                float d = glm::distance(v, currentPoint);
+                                if(d < dw) {
+                                    dw = d;
+                                    closestPoint = currentPoint;
+                                    closestSegment = candidateSegments[i / 2];
+                                }
+                            }
+                            out(y * wgs.width + x, signedDistance(v, dw, closestPoint, closestSegment));
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+
+/**
+ * Builds the per-pixel distance function of the configured backend and passes it on
+ * 
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ * @param visit function called once with the pixel function
+ */
+template<typename Visitor>
+static void visitPixelFunction(const glm::vec2 *samples, int sampleCount, const WGSettings& wgs, Visitor visit) {
+    if(wgs.backend == WGBackend::SegmentGrid || (wgs.backend == WGBackend::Windowed && wgs.isCorner)) {
+        // Corner seams are not functions of x, so the windowed search falls back to the grid
+        // Edge pixels scan segments from samples[i] to samples[i - 1]
+        SegmentGrid grid(samples, sampleCount, !wgs.isCorner, wgs.isCorner);
+        visit([&](int x, int y) {
+            float dw = wgs.width * wgs.height;
+            glm::vec2 v = {x, y}, closestPoint = {0.f, 0.f};
+            int segment = grid.closest(v, dw, closestPoint);
+            if(wgs.isCorner)
+                return cornerSignedDistance(samples, sampleCount, v, dw, segment);
+            return edgeSignedDistance(v, dw, closestPoint);
+        });
+    } else if(wgs.backend == WGBackend::Windowed) {
+        // Pixels whose window is wider than the grid's cells around them query the grid instead
+        SegmentGrid grid(samples, sampleCount, true);
+        int hint = 1;
+        visit([&](int x, int y) {
+            float dw;
+            glm::vec2 v = {x, y}, closestPoint;
+            int segment = windowedEdgeClosest(samples, sampleCount, v, hint, WINDOW_LIMIT, dw, closestPoint);
+            if(segment < 0) {
+                dw = wgs.width * wgs.height;
+                segment = grid.closest(v, dw, closestPoint);
+            }
+            hint = segment;
+            return edgeSignedDistance(v, dw, closestPoint);
+        });
+    } else if(wgs.backend == WGBackend::Approximate) {
+        // Per column (edge) or angular sector (corner): where the seam crosses it and how much of a
+        // vertical or radial offset lies along the seam normal, from the seam two pixels either side
+        constexpr float SLOPE_WINDOW = 2.0f;
+        int entries = wgs.isCorner ? 2 * std::max(wgs.width, wgs.height) : wgs.width;
+        auto crossingAt = [&](float k) {
+            glm::vec2 v = wgs.isCorner ? glm::vec2(entries - k - 0.5f, k + 0.5f) : glm::vec2(k, 0.0f);
+            return seamCrossing(samples, sampleCount, v, wgs.isCorner);
+        };
+        std::vector<glm::vec2> crossing(entries);
+        std::vector<float> correction(entries);
+        for(int k = 0; k < entries; ++k) {
+            crossing[k] = crossingAt(k);
+            float radius = std::max(glm::length(crossing[k]), 1.0f);
+            glm::vec2 along = wgs.isCorner ? crossing[k] / radius : glm::vec2(0.0f, 1.0f);
+            float reach = wgs.isCorner ? SLOPE_WINDOW * entries / (M_PI_2 * radius) : SLOPE_WINDOW;
+            glm::vec2 tangent = crossingAt(k + reach) - crossingAt(k - reach);
+            float length = glm::length(tangent);
+            correction[k] = length > 0.0f ? std::abs(along.x * tangent.y - along.y * tangent.x) / length : 1.0f;
+        }
+        visit([&](int x, int y) {
+            if(wgs.isCorner) {
+                int k = cornerSector({x, y}, entries);
+                return (std::sqrt(float(x * x + y * y)) - glm::length(crossing[k])) * correction[k];
+            }
+            return (y - crossing[x].y) * correction[x];
+        });
+    } else if(wgs.backend == WGBackend::Vectorized) {
+        SeamKernel kernel(samples, sampleCount);
+        visit([&](int x, int y) {
+            int segment;
+            glm::vec2 v = {x, y};
+            float dw = std::sqrt(kernel.closestSquared(v, segment));
+            if(wgs.isCorner)
+                return cornerSignedDistance(samples, sampleCount, v, dw, segment);
+            return edgeSignedDistance(v, dw, kernel.closestPoint(v, segment));
+        });
+    } else {
+        visit([&](int x, int y) {
+            if(wgs.isCorner)
+                return generateCornerDistancePixel(samples, sampleCount, x, y, wgs);
+            return generateEdgeDistancePixel(samples, sampleCount, x, y, wgs);
+        });
+    }
+}
+
+
+/**
+ * Polyline segments per spline segment used to bound the narrow band of spline seams
+ */
+static constexpr int SPLINE_TESSELLATION = 16;
+
+
+/**
+ * Generates a signed distance field to a spline fitted through the seam samples
+ * 
+ * @param out function storing signed distance d of pixel index i when called as out(i, d)
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ */
+template<typename DistanceOutput>
+static void generateSplineDistance(DistanceOutput out, const glm::vec2 *samples, int sampleCount, const WGSettings& wgs) {
+    SplineSeam spline(samples, sampleCount, wgs.splineSegments);
+    auto pixel = [&](int x, int y) {
+        glm::vec2 v = {x, y}, closestPoint = {0.f, 0.f}, tangent;
+        float dw = spline.closest(v, closestPoint, tangent);
+        if(wgs.isCorner)
+            return cornerSignedDistance(v, dw, closestPoint, tangent);
+        return edgeSignedDistance(v, dw, closestPoint);
+    };
+
+    // The band, blocks and pixel signs follow the spline, not the polyline it was fitted to
+    std::vector<glm::vec2> polyline = spline.tessellate(SPLINE_TESSELLATION);
+    if(wgs.coarseFactor > 1) {
+        generateCoarseToFineDistance(out, polyline.data(), polyline.size(), wgs, pixel);
+    } else {
+        // The tessellation's chords cut inside the spline's curves, so the band is widened by a
+        // pixel to keep every pixel within steepness of the spline itself
+        WGSettings bandSettings = wgs;
+        bandSettings.steepness += 1.0f;
+        generatePixelDistance(out, polyline.data(), polyline.size(), bandSettings, pixel);
+    }
+}
+
+
+/**
+ * Generates a signed distance field from euclidean seam samples using the configured backend
+ * 
+ * @param out function storing signed distance d of pixel index i when called as out(i, d)
+ * @param samples euclidean seam samples
+ * @param sampleCount amount of seam samples
+ * @param wgs walking gradient settings
+ */
+template<typename DistanceOutput>
+static void generateSeamDistance(DistanceOutput out, glm::vec2 *samples, int sampleCount, const WGSettings& wgs) {
+    if(wgs.backend == WGBackend::DistanceTransform) {
+        generateTransformDistance(out, samples, sampleCount, wgs);
+    } else if(wgs.backend == WGBackend::JumpFlood) {
+        generateJumpFloodDistance(out, samples, sampleCount, wgs);
+    } else if(wgs.backend == WGBackend::Blocked) {
+        generateBlockedDistance(out, samples, sampleCount, wgs);
+    } else if(wgs.backend == WGBackend::Spline) {
+        generateSplineDistance(out, samples, sampleCount, wgs);
+    } else {
+        visitPixelFunction(samples, sampleCount, wgs, [&](auto pixel) {
+            if(wgs.coarseFactor > 1)
+                generateCoarseToFineDistance(out, samples, sampleCount, wgs, pixel);
+            else
+                generatePixelDistance(out, samples, sampleCount, wgs, pixel);
+        });
+    }
+}
+
+
+/**
+ * Folds a value into a range by reflecting it off the range's ends
+ * 
+ * @param value the value to fold
+ * @param lo lower end of the range
+ * @param hi upper end of the range, greater than lo
+ * @return the folded value
+ */
+static float reflectIntoRange(float value, float lo, float hi) {
+    float span = hi - lo;
+    float u = std::fmod(value - lo, 2.0f * span);
+    if(u < 0.0f)
+        u += 2.0f * span;
+    return lo + (u <= span ? u : 2.0f * span - u);
+}
+
+
+/**
+ * Generates a random seam in euclidean coordinates
+ * 
+ * With a non-negative seamMargin the seam's height (edge) or radius (corner) is reflected
+ * off the margins, which keeps it inside the tile without retries. Both ends start at
+ * seamHeight, so they still meet as long as seamHeight lies within the margins.
+ * 
+ * @param wgs walking gradient settings
+ * @param sampleCount out: amount of seam samples
+ * @return euclidean seam samples
+ */
+static glm::vec2* generateSeam(const WGSettings& wgs, int& sampleCount) {
+    float lo = wgs.seamMargin;
+    float hi = (wgs.isCorner ? std::min(wgs.width, wgs.height) : wgs.height) - wgs.seamMargin;
+    bool bounded = wgs.seamMargin >= 0.0f && lo < hi;
+
+    if(!wgs.isCorner) {
+        glm::vec2 *samples = generateEdgeSamples(wgs, sampleCount);
+        for(int i = 0; bounded && i < sampleCount; ++i) {
+            samples[i].y = reflectIntoRange(samples[i].y, lo, hi);
+        }
+        return samples;
+    }
+
+    glm::vec2 *samples = generateCornerSamples(wgs, sampleCount);
+    glm::vec2 *eSamples = new glm::vec2[sampleCount];
+    for(int i = 0; bounded && i < sampleCount; ++i) {
+        samples[i].x = reflectIntoRange(samples[i].x, lo, hi);
+    }
+
+    int reach = sharedSeamReach(wgs);
+    euclidean(samples, eSamples, sampleCount, reach);
+    if(reach > 0)
+        straightenCornerEnds(samples, eSamples, sampleCount, reach, wgs.width / (wgs.sampleCount - 1.0f));
+
+    delete[] samples;
+    return eSamples;
+}
+
+template<typename DistanceOutput>
+static void generateDistance(DistanceOutput out, const WGSettings& wgs, WGStats& stats) {
+    auto start = std::chrono::steady_clock::now();
+    int sampleCount;
+    glm::vec2 *samples = generateSeam(wgs, sampleCount);
+    auto seamEnd = std::chrono::steady_clock::now();
+
+    generateSeamDistance(out, samples, sampleCount, wgs);
+
+    delete[] samples;
+    stats.seamMs = std::chrono::duration<double, std::milli>(seamEnd - start).count();
+    stats.distanceMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - seamEnd).count();
 }
 
-WalkingGradient::WalkingGradient(const WGSettings& wgs) : width(wgs.width), height(wgs.height) {
-    data = new float[width * height];
-    generateGradient(data, wgs);
 
+/**
+ * Applies the falloff to a whole signed distance field
+ * 
+ * @param distance signed distance field
+ * @param data out: gradient values
+ * @param count amount of values
+ * @param table falloff curve baked for the gradient's steepness
+ */
+template<typename T>
+static void applyFalloff(const float *distance, T *data, int count, const FalloffTable& table) {
+    for(int i = 0; i < count; ++i) {
+        data[i] = StorageTraits<T>::encode(table(distance[i]));
+    }
+}
 
+WalkingGradient::WalkingGradient(const WGSettings& wgs) : width(wgs.width), height(wgs.height), storage(wgs.storage), curve(wgs.curve), curveSamples(wgs.curveSamples) {
+    visitStorage(storage, [&](auto value) {
+        data = new unsigned char[width * height * sizeof(value)];
+    });
+    if(wgs.keepDistance) {
+        distance = new float[width * height];
+        generateDistance([&](int i, float d) { distance[i] = d; }, wgs, stats);
+        auto start = std::chrono::steady_clock::now();
+        setSteepness(wgs.steepness);
+        stats.falloffMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return;
+    }
+
+    // Without a kept field each distance is mapped and stored as soon as it is measured
+    distance = nullptr;
+    FalloffTable table(curve, wgs.steepness, curveSamples);
+    visitStorage(storage, [&](auto type) {
+        using T = decltype(type);
+        T *values = reinterpret_cast<T*>(data);
+        generateDistance([&](int i, float d) { values[i] = StorageTraits<T>::encode(table(d)); }, wgs, stats);
+    });
 }
 
 WalkingGradient::~WalkingGradient() {
-    delete data;
+    delete[] data;
     data = nullptr;
+    delete[] distance;
+    distance = nullptr;
 }
 
 float WalkingGradient::getValue(int x, int y) const {
-    return data[y * height + x];
+    float value;
+    visitStorage(storage, [&](auto type) {
+        using T = decltype(type);
+        value = StorageTraits<T>::decode(getValues<T>()[y * width + x]);
+    });
+    return value;
+}
+
+const WGStats& WalkingGradient::getStats() const {
+    return stats;
+}
+
+WGStorage WalkingGradient::getStorage() const {
+    return storage;
+}
+
+int WalkingGradient::getWidth() const {
+    return width;
+}
+
+int WalkingGradient::getHeight() const {
+    return height;
+}
+
+float WalkingGradient::getDistance(int x, int y) const {
+    if(distance == nullptr)
+        throw std::logic_error("WalkingGradient::getDistance requires keepDistance");
+    return distance[y * width + x];
+}
+
+int WalkingGradient::getSeamSampleCount(const WGSettings& wgs) {
+    return wgs.isCorner ? int(M_PI_4 * wgs.sampleCount) : wgs.sampleCount; // Quarter circle ratio
+}
+
+void WalkingGradient::generateSeamOffsets(const WGSettings& wgs, float *offsets) {
+    int count = getSeamSampleCount(wgs);
+    if(wgs.seam == WGSeam::Walk)
+        generateWalkOffsets(offsets, count, wgs);
+    else
+        generateSeamFunction(offsets, count, wgs);
+}
+
+void WalkingGradient::setSteepness(float steepness) {
+    if(distance == nullptr)
+        throw std::logic_error("WalkingGradient::setSteepness requires keepDistance");
+    FalloffTable table(curve, steepness, curveSamples);
+    visitStorage(storage, [&](auto type) {
+        applyFalloff(distance, reinterpret_cast<decltype(type)*>(data), width * height, table);
+    });
 }
 
 void WalkingGradient::invert() {
-    for(int i = 0; i < width * height; ++i) {
-        data[i] = 1.0f - data[i];
+    visitStorage(storage, [&](auto type) {
+        using T = decltype(type);
+        T *values = reinterpret_cast<T*>(data);
+        for(int i = 0; i < width * height; ++i) {
+            values[i] = StorageTraits<T>::invert(values[i]);
+        }
+    });
+    if(distance != nullptr) {
+        for(int i = 0; i < width * height; ++i) {
+            distance[i] = -distance[i];
+        }
     }
 }
 
 void WalkingGradient::flipX() {
-    float temp;
-    int yOffset;
-    for(int y = 0; y < height; ++y) {
-        yOffset = y * width;
-        for(int x = 0; x < width / 2; ++x) {
-            temp = data[yOffset + x];
-            data[yOffset + x] = data[yOffset + (width - 1 - x)];
-            data[yOffset + (width - 1 - x)] = temp;
-        }
-    }
+    visitStorage(storage, [&](auto type) {
+        flipTileX(data, width, height, sizeof(type));
+    });
+    if(distance != nullptr)
+        flipTileX(distance, width, height, sizeof(float));
 }
 
 void WalkingGradient::flipY() {
-    float temp;
-    int yOffset;
-    for(int y = 0; y < height / 2; ++y) {
-        yOffset = y * width;
-        for(int x = 0; x < width; ++x) {
-            temp = data[yOffset + x];
-            data[yOffset + x] = data[(height - 1 - y) * width + x];
-            data[(height - 1 - y) * width + x] = temp;
-        }
-    }
+    visitStorage(storage, [&](auto type) {
+        flipTileY(data, width, height, sizeof(type));
+    });
+    if(distance != nullptr)
+        flipTileY(distance, width, height, sizeof(float));
 }
 
 void WalkingGradient::transpose() {
-    float temp;
-    int yOffset;
-    for(int y = 0; y < height; ++y) {
-        yOffset = y * width;
-        for(int x = y + 1; x < width; ++x) {
-            temp = data[yOffset + x];
-            data[yOffset + x] = data[x * width + y];
-            data[x * width + y] = temp;
+    // Out of place, so tiles of any shape transpose with every access in cache
+    visitStorage(storage, [&](auto type) {
+        unsigned char *transposed = new unsigned char[width * height * sizeof(type)];
+        transposeTile(data, transposed, width, height, sizeof(type));
+        delete[] data;
+        data = transposed;
+    });
+    if(distance != nullptr) {
+        float *transposed = new float[width * height];
+        transposeTile(distance, transposed, width, height, sizeof(float));
+        delete[] distance;
+        distance = transposed;
+    }
+    std::swap(width, height);
+}
+
+void WalkingGradient::benchmark(const WGSettings& wgs) {
+    const std::pair<WGBackend, const char*> backends[] = {
+        {WGBackend::DistanceTransform, "transform"},
+        {WGBackend::SegmentGrid, "grid"},
+        {WGBackend::Windowed, "window"},
+        {WGBackend::Vectorized, "simd"},
+        {WGBackend::JumpFlood, "jumpflood"},
+        {WGBackend::Blocked, "blocked"},
+        {WGBackend::Spline, "spline"},
+        {WGBackend::Approximate, "approx"}
+    };
+    float *reference = new float[wgs.width * wgs.height];
+    float *result = new float[wgs.width * wgs.height];
+
+    std::cout << std::fixed << std::setprecision(3);
+    for(bool isCorner : {false, true}) {
+        WGSettings settings = wgs;
+        settings.isCorner = isCorner;
+        int sampleCount;
+        glm::vec2 *samples = generateSeam(settings, sampleCount);
+
+        // Reference is the plain brute force scan over every pixel
+        WGSettings referenceSettings = settings;
+        referenceSettings.backend = WGBackend::BruteForce;
+        referenceSettings.narrowBand = false;
+        referenceSettings.coarseFactor = 1;
+        auto start = std::chrono::steady_clock::now();
+        generateSeamDistance([&](int i, float d) { reference[i] = d; }, samples, sampleCount, referenceSettings);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << (isCorner ? "corner " : "edge   ") << std::setw(10) << "bruteforce"
+                  << std::setw(12) << elapsed.count() << " ms" << std::endl;
+
+        for(const auto& backend : backends) {
+            settings.backend = backend.first;
+            start = std::chrono::steady_clock::now();
+            generateSeamDistance([&](int i, float d) { result[i] = d; }, samples, sampleCount, settings);
+            elapsed = std::chrono::steady_clock::now() - start;
+
+            float maxError = 0.0f;
+            double meanError = 0.0;
+            for(int i = 0; i < wgs.width * wgs.height; ++i) {
+                float error = falloff(result[i], wgs.steepness) - falloff(reference[i], wgs.steepness);
+                maxError = std::max(maxError, std::abs(error));
+                meanError += std::abs(error);
+            }
+            // A gradient error e is a distance error of 2 * steepness * e pixels
+            std::cout << (isCorner ? "corner " : "edge   ") << std::setw(10) << backend.second
+                      << std::setw(12) << elapsed.count() << " ms"
+                      << "   max error " << std::setprecision(6) << maxError
+                      << " (" << maxError * 2.0f * wgs.steepness << " px)"
+                      << "   mean error " << meanError / (wgs.width * wgs.height) << std::setprecision(3) << std::endl;
         }
+
+        delete[] samples;
     }
+
+    delete[] result;
+    delete[] reference;
 }
 
 void WalkingGradient::debug() const {
@@ -234,7 +1491,7 @@ void WalkingGradient::debug() const {
     for(int y = 0; y < height; ++y) {
         int yOffset = y * width;
         for(int x = 0; x < width; ++x) {
-            test[yOffset + x] = (unsigned char)(255.0 * data[yOffset + x]);
+            test[yOffset + x] = (unsigned char)(255.0 * getValue(x, y));
         }
     }
     stbi_write_png("debug_walking_gradient.png", width, height, 1, test, 0);
@@ -5,6 +5,33 @@
  */
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
+#include "FalloffTable.h"
+#include "GradientStorage.h"
+#include "SeamFunction.h"
+
+class SeamBank;
+
+
+/**
+ * Definition of the WGBackend enum
+ * 
+ * Method used to compute the distance from each pixel to the seam
+ */
+enum class WGBackend {
+    BruteForce,         // Tests every seam segment for every pixel, reference mode
+    DistanceTransform,  // Bounds pixels by a distance transform of the rasterized seam, then refines exactly
+    SegmentGrid,        // Queries a uniform (edge) or polar (corner) grid of seam segments, matches the reference exactly
+    Vectorized,         // Scans every seam segment with SIMD, matches the reference within a few ULP
+    Windowed,           // Searches edge segments near each column, exact, corners use SegmentGrid
+    JumpFlood,          // Bounds pixels by jump flooding the rasterized seam, then refines exactly, splits across threads
+    Blocked,            // Scans 64x64 blocks against the segments near each, exact, splits across threads
+    Spline,             // Measures a Catmull-Rom spline through splineSegments + 1 seam samples
+    Approximate         // Slope-corrected vertical or radial offset from the seam, fastest, for previews
+};
+
 
 /**
  * Definition of the WGSettings struct
@@ -15,6 +42,36 @@ struct WGSettings {
     int width, height, sampleCount;
     float seamHeight, variance, steepness;
     bool isCorner;
+    WGBackend backend = WGBackend::BruteForce;
+    bool narrowBand = false;    // Only query distances within steepness of the seam
+    int threads = 1;            // Threads a single gradient may split its work across
+    int coarseFactor = 1;       // Block size of the coarse pass, 1 measures every pixel directly
+    int splineSegments = 16;    // Cubic segments of the Spline backend's seam
+    FalloffCurve curve = FalloffCurve::Linear;
+    std::vector<float> curveSamples;    // Curve values for FalloffCurve::Table
+    std::uint64_t seed = 0;     // Run seed, the same seed and tile always give the same seam
+    std::uint32_t tile = 0;     // Random stream of this gradient within the run
+    WGSeam seam = WGSeam::Walk;
+    int seamDetail = 16;        // Sine terms (Fourier) or noise cells (Noise) of closed form seams
+    float seamMargin = -1.0f;   // Keeps the seam this far inside the tile by reflection, negative disables
+    const SeamBank *seamBank = nullptr; // Pre-generated seams picked by seed and tile instead of generating one
+    std::vector<float> seamPath;    // Hand-authored seam as interleaved x, y pixels, replaces the random seam if not empty
+    std::vector<float> seamStart;   // Odd count of offsets centered on the seam's first sample, shared with the neighbour there
+    std::vector<float> seamEnd;     // Odd count of offsets centered on the seam's last sample, shared with the neighbour there
+    WGStorage storage = WGStorage::Float;
+    bool keepDistance = true;   // Keep the signed distance field for setSteepness, otherwise values are stored as distances are measured
+};
+
+
+/**
+ * Definition of the WGStats struct
+ * 
+ * Work done while constructing a walking gradient
+ */
+struct WGStats {
+    double seamMs = 0.0;        // Time spent sampling the seam
+    double distanceMs = 0.0;    // Time spent measuring the signed distance field
+    double falloffMs = 0.0;     // Time spent mapping distances to gradient values, 0 without keepDistance as it is part of distanceMs
 };
 
 
@@ -44,10 +101,83 @@ class WalkingGradient {
         float getValue(int x, int y) const;
 
 
+        /**
+         * Gets the counters and timings of the gradient's construction
+         * 
+         * @return construction statistics
+         */
+        const WGStats& getStats() const;
+
+
+        /**
+         * Gets the type gradient values are stored as
+         * 
+         * @return the storage type
+         */
+        WGStorage getStorage() const;
+
+
+        /**
+         * Gets the width of the gradient, its height before a transpose of a non-square tile
+         * 
+         * @return row length in pixels
+         */
+        int getWidth() const;
+
+
+        /**
+         * Gets the height of the gradient
+         * 
+         * @return amount of rows
+         */
+        int getHeight() const;
+
+
+        /**
+         * Gets the stored gradient values, row by row
+         * 
+         * @tparam T the type matching getStorage(): float, Half, std::uint16_t or std::uint8_t
+         * @return the gradient values
+         */
+        template<typename T>
+        const T* getValues() const {
+            return reinterpret_cast<const T*>(data);
+        }
+
+
+        /**
+         * Gets the signed distance from a pixel to the seam
+         * 
+         * Positive above (edge) or outside (corner) of the seam. Pixels skipped by the
+         * narrow band hold positive or negative infinity. Requires keepDistance.
+         * 
+         * @param x the pixel column
+         * @param y the pixel row
+         * @return signed distance in pixels
+         * @throws std::logic_error if the gradient was generated without keepDistance
+         */
+        float getDistance(int x, int y) const;
+
+
+        /**
+         * Re-applies the falloff to the cached signed distance field
+         * 
+         * Lets one seam be blended at several steepness values without recomputing distances.
+         * The gradient's falloff curve is rebaked into a lookup table for the new steepness.
+         * With narrow band enabled distances are only known up to the steepness the gradient
+         * was generated with, so larger values need a gradient generated at that steepness.
+         * Requires keepDistance.
+         * 
+         * @param steepness the reach of the gradient's blending in pixels
+         * @throws std::logic_error if the gradient was generated without keepDistance
+         */
+        void setSteepness(float steepness);
+
+
         /**
          * Replaces all mapped gradient values g to 1.0 - g
          * 
-         * Conserves gradient value's position
+         * Conserves gradient value's position, signed distances are negated
          */
         void invert();
 
@@ -66,10 +196,40 @@ class WalkingGradient {
 
         /**
          * Transposes gradient like a 2D matrix
+         * 
+         * Tiles of any shape are supported, width and height are swapped.
          */
         void transpose();
 
 
+        /**
+         * Times every backend on the same edge and corner seams and prints the results
+         * 
+         * Reports each backend's maximum error against the brute force reference.
+         * 
+         * @param wgs walking gradient settings, isCorner and backend are overridden
+         */
+        static void benchmark(const WGSettings& wgs);
+
+
+        /**
+         * Gets the amount of samples of an edge or corner seam
+         * 
+         * @param wgs walking gradient settings
+         * @return sampleCount for edges, a quarter circle's share of it for corners
+         */
+        static int getSeamSampleCount(const WGSettings& wgs);
+
+
+        /**
+         * Generates the offsets of a seam from seamHeight, ignoring seamBank and seamMargin
+         * 
+         * @param wgs walking gradient settings
+         * @param offsets out: getSeamSampleCount(wgs) offsets, the first and last are 0
+         */
+        static void generateSeamOffsets(const WGSettings& wgs, float *offsets);
+
+
         /**
          * Saves a grayscale image of the gradient to the cwd
          * 
@@ -78,6 +238,11 @@ class WalkingGradient {
         void debug() const;
 
     private:
-        float *data;
+        float *distance;
+        unsigned char *data;
         int width, height;
+        WGStorage storage;
+        WGStats stats;
+        FalloffCurve curve;
+        std::vector<float> curveSamples;
 };
\ No newline at end of file
@@ -4,6 +4,8 @@
  * Main file holding the entry main function for the connected textures program
  */
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -12,6 +14,9 @@
 
 #include "dr_opt.h"
 #include "CTFactory.h"
+#include "SeamBank.h"
+#include "SeamPath.h"
+#include "WalkingGradient.h"
 
 namespace fs = std::filesystem;
 
@@ -46,6 +51,43 @@ static void createDefaultSettingsFile(const fs::path& settingsFilePath) {
     outf << std::endl;
     outf << "The amplification applied to the walking gradient algorithm" << std::endl;
     outf << "variance = 5" << std::endl;
+    outf << std::endl;
+    outf << "How seam distances are computed: bruteforce (reference), grid (indexed, exact), window (column search, exact), simd (vectorized scan), jumpflood (parallel, exact), blocked (parallel, exact), spline (smooth, few segments), approx (previews) or transform (distance transform bound, exact)" << std::endl;
+    outf << "backend = grid" << std::endl;
+    outf << std::endl;
+    outf << "Only compute distances for pixels within steepness of the seam: true or false" << std::endl;
+    outf << "narrowBand = true" << std::endl;
+    outf << std::endl;
+    outf << "Threads each gradient may split its work across (used by the jumpflood backend)" << std::endl;
+    outf << "threads = 1" << std::endl;
+    outf << std::endl;
+    outf << "Measure distances on blocks of this size first and refine only blocks near the seam, 1 to disable" << std::endl;
+    outf << "coarseFactor = 1" << std::endl;
+    outf << std::endl;
+    outf << "Cubic segments of the seam with backend = spline" << std::endl;
+    outf << "splineSegments = 16" << std::endl;
+    outf << std::endl;
+    outf << "Shape of the blend across the seam: linear, smoothstep, cosine or a path to a file of curve values from 0 to 1" << std::endl;
+    outf << "falloff = linear" << std::endl;
+    outf << std::endl;
+    outf << "Type gradients are stored as: float, half, uint16 or uint8 (least memory, enough for 8-bit output)" << std::endl;
+    outf << "storage = float" << std::endl;
+    outf << std::endl;
+    outf << "How seams are generated: walk (random walk), fourier (sine series) or noise (gradient noise)" << std::endl;
+    outf << "seam = walk" << std::endl;
+    outf << std::endl;
+    outf << "Sine terms or noise cells of fourier and noise seams, higher values give finer detail" << std::endl;
+    outf << "seamDetail = 16" << std::endl;
+    outf << std::endl;
+    outf << "Seams are reflected to stay at least this many pixels inside the tile, -1 lets them wander off" << std::endl;
+    outf << "seamMargin = 0" << std::endl;
+    outf << std::endl;
+    outf << "Seam samples on each side of a tile border taken from one boundary seam shared by every tile, so borders match while these samples reach past steepness, 0 disables" << std::endl;
+    outf << "sharedBorder = 0" << std::endl;
+    outf << std::endl;
+    outf << "Paths to hand-authored edge and corner seams (CSV points or an SVG path) used instead of random seams, none for random" << std::endl;
+    outf << "edgeSeam = none" << std::endl;
+    outf << "cornerSeam = none" << std::endl;
     outf.close();
 }
 
@@ -80,7 +122,10 @@ int main(int argc, char* args[]) {
     dr::setopt(argc, args);
     // Check for correct number of options/arguments
     int optCount = dr::getoptc();
-    if(optCount < 3) {
+    bool benchFlag = dr::hasopt("bench");
+    bool makeBankFlag = dr::hasopt("makebank");
+    bool borderCheckFlag = dr::hasopt("bordercheck");
+    if(optCount < 3 && !benchFlag && !makeBankFlag && !borderCheckFlag) {
         printUsage();
         return 0;
     }
@@ -114,13 +159,22 @@ int main(int argc, char* args[]) {
         oFlag = true;
     }
 
+    // Get seed, a fresh one is printed so the run can be repeated
+    std::uint64_t seed;
+    if (dr::hasopt("seed")) {
+        seed = std::stoull(dr::getopt("seed"));
+    } else {
+        seed = std::chrono::system_clock::now().time_since_epoch().count();
+        std::cout << "Seed: " << seed << std::endl;
+    }
+
     // Get settings path
     if (dr::hasopt("s")) {
         settingsPath = fs::path(dr::getopt("s"));
     }
 
     // If required options weren't loaded, exit program
-    if(!tFlag || !bFlag || !oFlag) {
+    if(!benchFlag && !makeBankFlag && !borderCheckFlag && (!tFlag || !bFlag || !oFlag)) {
         std::cerr << "Program requires top, bottom, and output image location" << std::endl;
         printUsage();
         return 0;
@@ -146,6 +200,7 @@ int main(int argc, char* args[]) {
 
     // Load settings into CTSettings object, default if no property found in file
     CTSettings cts = CTSettings();
+    cts.seed = seed;
     auto it = settings.find("sampleCount");
     if(it != settings.end()) {
         cts.sampleCount = std::stoi(it->second);
@@ -170,6 +225,158 @@ int main(int argc, char* args[]) {
     } else {
         cts.variance = 5.0f;
     }
+    it = settings.find("backend");
+    if(it != settings.end() && it->second == "bruteforce") {
+        cts.backend = WGBackend::BruteForce;
+    } else if(it != settings.end() && it->second == "grid") {
+        cts.backend = WGBackend::SegmentGrid;
+    } else if(it != settings.end() && it->second == "simd") {
+        cts.backend = WGBackend::Vectorized;
+    } else if(it != settings.end() && it->second == "window") {
+        cts.backend = WGBackend::Windowed;
+    } else if(it != settings.end() && it->second == "jumpflood") {
+        cts.backend = WGBackend::JumpFlood;
+    } else if(it != settings.end() && it->second == "blocked") {
+        cts.backend = WGBackend::Blocked;
+    } else if(it != settings.end() && it->second == "spline") {
+        cts.backend = WGBackend::Spline;
+    } else if(it != settings.end() && it->second == "approx") {
+        cts.backend = WGBackend::Approximate;
+    } else if(it != settings.end() && it->second == "transform") {
+        cts.backend = WGBackend::DistanceTransform;
+    } else if(it == settings.end()) {
+        cts.backend = WGBackend::SegmentGrid;
+    } else {
+        std::cerr << "Unknown backend " << it->second << std::endl;
+        return 0;
+    }
+    it = settings.find("narrowBand");
+    if(it != settings.end()) {
+        cts.narrowBand = it->second == "true";
+    } else {
+        cts.narrowBand = true;
+    }
+    it = settings.find("threads");
+    if(it != settings.end()) {
+        cts.threads = std::stoi(it->second);
+    } else {
+        cts.threads = 1;
+    }
+    it = settings.find("coarseFactor");
+    if(it != settings.end()) {
+        cts.coarseFactor = std::stoi(it->second);
+    } else {
+        cts.coarseFactor = 1;
+    }
+    it = settings.find("splineSegments");
+    if(it != settings.end()) {
+        cts.splineSegments = std::stoi(it->second);
+    } else {
+        cts.splineSegments = 16;
+    }
+    it = settings.find("falloff");
+    if(it != settings.end() && it->second == "smoothstep") {
+        cts.curve = FalloffCurve::Smoothstep;
+    } else if(it != settings.end() && it->second == "cosine") {
+        cts.curve = FalloffCurve::Cosine;
+    } else if(it != settings.end() && it->second != "linear") {
+        // Anything else names a curve file
+        cts.curve = FalloffCurve::Table;
+        if(!FalloffTable::loadCurve(fs::path(it->second), cts.curveSamples)) {
+            std::cerr << "Could not load falloff curve " << it->second << std::endl;
+            return 0;
+        }
+    } else {
+        cts.curve = FalloffCurve::Linear;
+    }
+    it = settings.find("storage");
+    if(it != settings.end() && it->second == "half") {
+        cts.storage = WGStorage::Half;
+    } else if(it != settings.end() && it->second == "uint16") {
+        cts.storage = WGStorage::UInt16;
+    } else if(it != settings.end() && it->second == "uint8") {
+        cts.storage = WGStorage::UInt8;
+    } else {
+        cts.storage = WGStorage::Float;
+    }
+    it = settings.find("seam");
+    if(it != settings.end() && it->second == "fourier") {
+        cts.seam = WGSeam::Fourier;
+    } else if(it != settings.end() && it->second == "noise") {
+        cts.seam = WGSeam::Noise;
+    } else {
+        cts.seam = WGSeam::Walk;
+    }
+    it = settings.find("seamDetail");
+    if(it != settings.end()) {
+        cts.seamDetail = std::stoi(it->second);
+    } else {
+        cts.seamDetail = 16;
+    }
+    it = settings.find("seamMargin");
+    if(it != settings.end()) {
+        cts.seamMargin = std::stof(it->second);
+    } else {
+        cts.seamMargin = 0.0f;
+    }
+    it = settings.find("sharedBorder");
+    if(it != settings.end()) {
+        cts.sharedBorder = std::stoi(it->second);
+    } else {
+        cts.sharedBorder = 0;
+    }
+    it = settings.find("edgeSeam");
+    if(it != settings.end() && it->second != "none") {
+        if(!loadSeamPath(fs::path(it->second), cts.edgeSeamPath)) {
+            std::cerr << "Could not load edge seam " << it->second << std::endl;
+            return 0;
+        }
+    }
+    it = settings.find("cornerSeam");
+    if(it != settings.end() && it->second != "none") {
+        if(!loadSeamPath(fs::path(it->second), cts.cornerSeamPath)) {
+            std::cerr << "Could not load corner seam " << it->second << std::endl;
+            return 0;
+        }
+    }
+
+    // Write a bank of seams with these settings instead of generating a texture
+    if(makeBankFlag) {
+        int count = dr::hasopt("bankcount") ? std::stoi(dr::getopt("bankcount")) : 4096;
+        if(!CTFactory::writeSeamBank(cts, fs::path(dr::getopt("makebank")), count)) {
+            std::cerr << "Could not write seam bank " << dr::getopt("makebank") << std::endl;
+        }
+        return 0;
+    }
+
+    // Pick seams from a seam bank instead of generating them
+    SeamBank seamBank;
+    if(dr::hasopt("bank")) {
+        if(!seamBank.open(fs::path(dr::getopt("bank")))) {
+            std::cerr << "Could not load seam bank " << dr::getopt("bank") << std::endl;
+            return 0;
+        }
+        if(seamBank.getHeader().edgeSampleCount != std::uint32_t(cts.sampleCount)) {
+            std::cerr << "Seam bank was generated with sampleCount = " << seamBank.getHeader().edgeSampleCount << std::endl;
+            return 0;
+        }
+        cts.seamBank = &seamBank;
+    }
+
+    // Benchmark gradient backends instead of generating a texture
+    if(benchFlag) {
+        const std::string& size = dr::getopt("bench");
+        CTFactory::benchmark(cts, size.empty() ? 128 : std::stoi(size));
+        return 0;
+    }
+
+    // Check that tiles continue across their borders for a run of seeds instead of generating a texture
+    if(borderCheckFlag) {
+        const std::string& size = dr::getopt("bordercheck");
+        int count = dr::hasopt("bordercount") ? std::stoi(dr::getopt("bordercount")) : 32;
+        CTFactory::checkBorders(cts, size.empty() ? 128 : std::stoi(size), count);
+        return 0;
+    }
     
     // Start the connected textures factory
     CTFactory ctf(topImagePath, bottomImagePath, outImagePath, cts);